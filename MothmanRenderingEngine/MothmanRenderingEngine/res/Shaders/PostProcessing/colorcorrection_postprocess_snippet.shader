@@ -0,0 +1,9 @@
+//Color correction (fused by PostProcessCompiler)
+
+uniform float u_gamma;
+uniform vec4 u_tint;
+
+vec4 ColorCorrection(vec4 color)
+{
+	return vec4(pow(color.rgb * u_tint.rgb, vec3(1.0 / u_gamma)), color.a);
+}
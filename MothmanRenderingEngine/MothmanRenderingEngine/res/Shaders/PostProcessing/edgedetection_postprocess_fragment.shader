@@ -7,6 +7,7 @@ in vec2 v_texCoords;
 uniform sampler2D s_screenTexture;
 
 uniform float u_offset;
+uniform vec2 u_uvScale = vec2(1.0); //Same as in screen vertex shader (initializers have to match)
 
 void main()
 {
@@ -33,7 +34,8 @@ void main()
 	vec3 sampleTex[9];
 	for (int i = 0; i < 9; i++)
 	{
-		sampleTex[i] = vec3(texture(s_screenTexture, v_texCoords.st + offsets[i]));
+		vec2 sampleCoords = clamp(v_texCoords.st + offsets[i] * u_uvScale, vec2(0.0), u_uvScale - 0.5 / vec2(textureSize(s_screenTexture, 0))); //Stay inside of the image
+		sampleTex[i] = vec3(texture(s_screenTexture, sampleCoords));
 	}
 	vec3 col = vec3(0.0);
 	for (int i = 0; i < 9; i++)
@@ -0,0 +1,18 @@
+#version 330
+
+//Template of the fused post-processing shader. PostProcessCompiler inserts snippets of enabled effects
+//in place of EFFECT_FUNCTIONS and calls to them in place of EFFECT_CALLS (in order effects are applied)
+
+out vec4 color;
+
+in vec2 v_texCoords;
+
+uniform sampler2D s_screenTexture;
+
+//EFFECT_FUNCTIONS
+
+void main()
+{
+	color = texture(s_screenTexture, v_texCoords);
+	//EFFECT_CALLS
+}
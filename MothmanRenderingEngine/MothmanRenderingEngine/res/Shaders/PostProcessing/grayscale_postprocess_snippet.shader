@@ -0,0 +1,7 @@
+//Grayscale (fused by PostProcessCompiler)
+
+vec4 Grayscale(vec4 color)
+{
+	float average = 0.2126 * color.r + 0.7152 * color.g + 0.0722 * color.b;
+	return vec4(average, average, average, 1.0);
+}
@@ -0,0 +1,6 @@
+//Invert (fused by PostProcessCompiler)
+
+vec4 Invert(vec4 color)
+{
+	return vec4(vec3(1.0) - color.rgb, 1.0);
+}
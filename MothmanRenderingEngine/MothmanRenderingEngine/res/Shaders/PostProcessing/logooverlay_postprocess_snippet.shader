@@ -1,20 +1,14 @@
-#version 330
+//Logo overlay (fused by PostProcessCompiler)
 
-out vec4 color;
-
-in vec2 v_texCoords;
-
-uniform sampler2D s_screenTexture;
 uniform sampler2D s_logoOverlayTexture;
 uniform vec4 u_logoOverlayTint;
 uniform vec2 u_framebufferDimensions;
 uniform vec2 u_logoOverlayTextureDimensions;
 
-void main()
+vec4 LogoOverlay(vec4 color)
 {
-	color = texture(s_screenTexture, v_texCoords);
 	vec2 textureRatio = u_framebufferDimensions / u_logoOverlayTextureDimensions;
-	vec2 logoOverlayTexCoords = textureRatio * v_texCoords;
+	vec2 logoOverlayTexCoords = textureRatio * (gl_FragCoord.xy / u_framebufferDimensions);
 
 	logoOverlayTexCoords *= 5.0;
 	logoOverlayTexCoords.y += 0.2; //Move down
@@ -24,6 +18,5 @@ void main()
 	float maskY = step(logoOverlayTexCoords.y, 1.0) * step(0.0, logoOverlayTexCoords.y);
 	vec4 logoOverlay = texture(s_logoOverlayTexture, logoOverlayTexCoords * vec2(1.0, -1.0));
 
-	color = vec4(mix(color, u_logoOverlayTint, logoOverlay.r * maskX * maskY).rgb, 0.5);
-
-}
\ No newline at end of file
+	return vec4(mix(color, u_logoOverlayTint, logoOverlay.r * maskX * maskY).rgb, 0.5);
+}
@@ -0,0 +1,37 @@
+#version 330
+
+out vec2 occlusion;
+
+in vec2 v_texCoords;
+
+uniform sampler2D s_occlusion; //r - occlusion, g - view depth
+uniform float u_depthSharpness; //How fast weight drops with relative depth difference
+uniform vec2 u_uvScale = vec2(1.0); //Same as in screen vertex shader (initializers have to match)
+
+void main()
+{
+	vec2 texelSize = 1.0 / vec2(textureSize(s_occlusion, 0));
+	vec2 center = texture(s_occlusion, v_texCoords).rg;
+	if (center.g <= 0.0)
+	{
+		occlusion = center;
+		return;
+	}
+
+	//4x4 area covers one tile of the noise texture, so noise pattern is averaged out
+	float sum = 0.0;
+	float weightSum = 0.0;
+	for (int x = -2; x < 2; x++)
+	{
+		for (int y = -2; y < 2; y++)
+		{
+			vec2 neighbourCoords = clamp(v_texCoords + vec2(x, y) * texelSize, vec2(0.0), u_uvScale - texelSize * 0.5); //Stay inside of the image
+			vec2 neighbour = texture(s_occlusion, neighbourCoords).rg;
+			float weight = max(0.0, 1.0 - abs(neighbour.g - center.g) / center.g * u_depthSharpness);
+			sum += neighbour.r * weight;
+			weightSum += weight;
+		}
+	}
+
+	occlusion = vec2(sum / max(weightSum, 0.0001), center.g);
+}
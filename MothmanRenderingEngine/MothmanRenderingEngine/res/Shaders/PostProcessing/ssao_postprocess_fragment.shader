@@ -1,54 +1,71 @@
 #version 330
 
-out vec4 color;
+out vec2 occlusion; //r - ambient occlusion (1 - not occluded), g - view depth of the pixel (for blur and upsample)
 
 in vec2 v_texCoords;
 
-uniform sampler2D s_screenTexture;
-
-uniform sampler2D s_position;
-uniform sampler2D s_normal;
+uniform sampler2D s_depthNormal; //xyz - view space normal, w - linear view depth
 uniform sampler2D s_texNoise;
 
-uniform vec3 u_samples[64];
-uniform mat4 u_projection;
+layout(std140) uniform SSAOKernel
+{
+	vec4 u_samples[64]; //Has to match SSAO_MAX_SAMPLES_PER_KERNEL
+};
 
-uniform vec2 u_framebufferDimensions;
+uniform mat4 u_projection;
+uniform vec2 u_uvScale = vec2(1.0); //Same as in screen vertex shader, v_texCoords are already scaled
 
 uniform int u_kernelSize;
 uniform float u_kernelRadius;
 uniform float u_bias;
 
+vec3 ViewPosition(vec2 uv, float depth) //Undo perspective projection of point with known view depth
+{
+	vec2 ndc = uv * 2.0 - 1.0;
+	return vec3(ndc.x * depth / u_projection[0][0], ndc.y * depth / u_projection[1][1], -depth);
+}
+
 void main()
 {
-	const vec2 noiseScale = u_framebufferDimensions / 2; 
+	vec4 depthNormal = texture(s_depthNormal, v_texCoords);
+	float depth = depthNormal.w;
+	if (depth <= 0.0) //Sky
+	{
+		occlusion = vec2(1.0, 0.0);
+		return;
+	}
 
-	vec3 fragPos = texture(s_position, v_texCoords).xyz;
-	vec3 normal = texture(s_normal, v_texCoords).rgb;
-	vec3 randomVec = texture(s_texNoise, v_texCoords * noiseScale).xyz;
+	vec3 fragPos = ViewPosition(v_texCoords / u_uvScale, depth);
+	vec3 normal = normalize(depthNormal.xyz);
+	vec3 randomVec = texture(s_texNoise, gl_FragCoord.xy / vec2(textureSize(s_texNoise, 0))).xyz; //Noise tiled over the target
 
 	vec3 tangent = normalize(randomVec - normal * dot(randomVec, normal));
 	vec3 bitangent = cross(normal, tangent);
 	mat3 TBN = mat3(tangent, bitangent, normal); //tangent-space to view-space matrix
 
-	float occlusion = 0.0;
+	float occluded = 0.0;
 	for (int i = 0; i < u_kernelSize; ++i)
 	{
-		vec3 samplee = TBN * samples[i]; //Get sample position From tangent to view-space
-		samplee = fragPos + samplee * u_kernelRadius;
+		vec3 samplePos = fragPos + TBN * u_samples[i].xyz * u_kernelRadius; //Get sample position From tangent to view-space
 
 		//transform sample to screen - space
-		vec4 offset = vec4(samplee, 1.0);
-		offset = projection * offset;    // from view to clip-space
-		offset.xyz /= offset.w;               // perspective divide
-		offset.xyz = offset.xyz * 0.5 + 0.5; // transform to range 0.0 - 1.0
-
-		float sampleDepth = texture(s_position, offset.xy).z;
-		float rangeCheck = smoothstep(0.0, 1.0, u_radius / abs(fragPos.z - sampleDepth));
-		occlusion += (sampleDepth >= samplee.z + u_bias ? 1.0 : 0.0) * rangeCheck;
+		vec4 offset = u_projection * vec4(samplePos, 1.0);
+		offset.xy = (offset.xy / offset.w) * 0.5 + 0.5;
+		if (any(lessThan(offset.xy, vec2(0.0))) || any(greaterThan(offset.xy, vec2(1.0)))) //Outside of the screen
+		{
+			continue;
+		}
+
+		float sampleDepth = texture(s_depthNormal, offset.xy * u_uvScale).w;
+		if (sampleDepth <= 0.0) //Sky doesn't occlude
+		{
+			continue;
+		}
+
+		float sampleZ = -sampleDepth;
+		float rangeCheck = smoothstep(0.0, 1.0, u_kernelRadius / abs(fragPos.z - sampleZ));
+		occluded += (sampleZ >= samplePos.z + u_bias ? 1.0 : 0.0) * rangeCheck;
 	}
-	occlusion = 1.0 - (occlusion / u_kernelSize);
-	color = occlusion;
 
-	//color = texture(s_screenTexture, v_texCoords);
+	occlusion = vec2(1.0 - (occluded / u_kernelSize), depth);
 }
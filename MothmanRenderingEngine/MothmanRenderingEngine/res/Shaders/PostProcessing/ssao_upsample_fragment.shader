@@ -0,0 +1,43 @@
+#version 330
+
+out vec4 color;
+
+in vec2 v_texCoords;
+
+uniform sampler2D s_screenTexture;
+uniform sampler2D s_depthNormal; //Full resolution, linear view depth in w
+uniform sampler2D s_occlusion; //Low resolution, r - occlusion, g - view depth
+uniform float u_depthSharpness;
+uniform vec2 u_occlusionScale; //Low resolution size / full resolution size (of the images, not textures)
+uniform vec2 u_occlusionExtent; //Low resolution image size
+
+void main()
+{
+	color = texture(s_screenTexture, v_texCoords);
+	float depth = texture(s_depthNormal, v_texCoords).w;
+	if (depth <= 0.0)
+	{
+		return;
+	}
+
+	//Four nearest low resolution pixels, bilinear weights reduced for pixels at different depth (so edges stay sharp)
+	ivec2 lowSize = ivec2(u_occlusionExtent);
+	vec2 position = gl_FragCoord.xy * u_occlusionScale - 0.5;
+	ivec2 base = ivec2(floor(position));
+	vec2 f = fract(position);
+	vec4 bilinear = vec4((1.0 - f.x) * (1.0 - f.y), f.x * (1.0 - f.y), (1.0 - f.x) * f.y, f.x * f.y);
+	ivec2 offsets[4] = ivec2[](ivec2(0, 0), ivec2(1, 0), ivec2(0, 1), ivec2(1, 1));
+
+	float sum = 0.0;
+	float weightSum = 0.0;
+	for (int i = 0; i < 4; i++)
+	{
+		vec2 neighbour = texelFetch(s_occlusion, clamp(base + offsets[i], ivec2(0), lowSize - 1), 0).rg;
+		float weight = bilinear[i] / (0.001 + abs(neighbour.g - depth) / depth * u_depthSharpness);
+		sum += neighbour.r * weight;
+		weightSum += weight;
+	}
+
+	float ambientOcclusion = weightSum > 0.0 ? sum / weightSum : 1.0;
+	color = vec4(color.rgb * ambientOcclusion, color.a);
+}
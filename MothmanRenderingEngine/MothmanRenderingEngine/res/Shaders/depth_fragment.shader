@@ -1,10 +1,11 @@
 #version 330
 
-out vec4 color;
+out vec4 color; //xyz - view space normal, w - linear view depth (0 where nothing was rendered)
+
+in vec3 v_viewNormal;
+in float v_viewDepth;
 
 void main() 
 {
-     color = vec4(vec3(gl_FragCoord.z), 1.0);
-}													
-
-
+     color = vec4(normalize(v_viewNormal), v_viewDepth);
+}
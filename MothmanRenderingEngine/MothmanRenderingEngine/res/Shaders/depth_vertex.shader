@@ -1,14 +1,24 @@
 #version 330
 
 layout (location = 0) in vec3 pos; //Position of vertex (glVertexAttribPointer in mesh)
+layout (location = 2) in vec3 norm;
+layout (location = 4) in mat4 model; //Per-instance model matrix
 
-uniform mat4 u_model;	
-uniform mat4 u_projection;
-uniform mat4 u_view;
+out vec3 v_viewNormal;
+out float v_viewDepth;
+
+layout (std140) uniform PassUniforms //Slot of the depth pass, bound by its command list
+{
+	mat4 u_projection;
+	mat4 u_view;
+};
 
 void main() 
 {
-    gl_Position = u_projection * u_view * u_model * vec4(pos, 1.0);
+	vec4 viewPos = u_view * model * vec4(pos, 1.0);
+	v_viewNormal = mat3(u_view) * mat3(transpose(inverse(model))) * norm; //Prevent changing direction of normals when mesh is scaled
+	v_viewDepth = -viewPos.z;
+    gl_Position = u_projection * viewPos;
 }													
 
 
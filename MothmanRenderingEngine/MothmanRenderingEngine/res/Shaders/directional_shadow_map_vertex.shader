@@ -1,12 +1,16 @@
 #version 330
 
 layout (location = 0) in vec3 pos; //Position of a vertex
+layout (location = 4) in mat4 model; //Per-instance model matrix
 
-uniform mat4 u_model;
-uniform mat4 u_directionalLightTransform; //Point of view of the light
+layout (std140) uniform PassUniforms //Slot of the cascade, bound by its command list
+{
+	mat4 u_projection; //Transform of the cascade (point of view of the light)
+	mat4 u_view; //Identity
+};
 
 void main()
 {
-	gl_Position = u_directionalLightTransform * u_model * vec4(pos, 1.0); //Converting position of the vertex to the coordinates from the camera point of view
+	gl_Position = u_projection * u_view * model * vec4(pos, 1.0); //Converting position of the vertex to the coordinates from the camera point of view
 }
 
@@ -0,0 +1,41 @@
+#version 330
+in vec2 v_texCoords;
+
+out vec4 color;
+
+uniform sampler2D s_source; //Shadow atlas depth (first pass) or horizontally blurred moments (second pass)
+uniform vec4 u_sourceRect; //Filtered part of the source texture, xy - offset, zw - size (in uv)
+uniform vec2 u_texelStep; //Distance between neighbour blur taps in source uv
+uniform int u_fromDepth; //1 - source holds depth that has to be converted to moments before blurring
+
+const float EVSM_POSITIVE_EXPONENT = 5.54; //Largest exponents that keep moments in 16 bit float range
+const float EVSM_NEGATIVE_EXPONENT = 5.54;
+const float weights[5] = float[](0.227027, 0.1945946, 0.1216216, 0.054054, 0.016216); //Gaussian, 9 taps
+
+vec4 CalcMoments(float depth)
+{
+	depth = depth * 2.0 - 1.0;
+	float positive = exp(EVSM_POSITIVE_EXPONENT * depth);
+	float negative = -exp(-EVSM_NEGATIVE_EXPONENT * depth);
+	return vec4(positive, positive * positive, negative, negative * negative);
+}
+
+vec4 Fetch(vec2 texCoords)
+{
+	vec2 halfTexel = 0.5 / vec2(textureSize(s_source, 0));
+	texCoords = clamp(texCoords, u_sourceRect.xy + halfTexel, u_sourceRect.xy + u_sourceRect.zw - halfTexel); //Do not blur neighbour tiles in
+	vec4 value = texture(s_source, texCoords);
+	return u_fromDepth != 0 ? CalcMoments(value.r) : value;
+}
+
+void main()
+{
+	vec2 texCoords = u_sourceRect.xy + v_texCoords * u_sourceRect.zw;
+
+	color = Fetch(texCoords) * weights[0];
+	for (int i = 1; i < 5; i++)
+	{
+		color += Fetch(texCoords + u_texelStep * float(i)) * weights[i];
+		color += Fetch(texCoords - u_texelStep * float(i)) * weights[i];
+	}
+}
\ No newline at end of file
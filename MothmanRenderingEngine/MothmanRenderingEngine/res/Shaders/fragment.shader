@@ -8,13 +8,21 @@ in vec2 v_texCoords;
 in vec3 v_normal;
 //flat in vec3 v_normal; //OpenGL keyword to create fast flat shading (should not be used)
 in vec3 v_fragPos;
-in vec4 v_directionalLightSpacePos; //Where position of a fragment is relative to the light (light point of view)
+in float v_viewDepth; //Distance from camera plane, used to select shadow cascade
 in mat3 v_TBN;
 
 out vec4 color;
 
-const int MAX_POINT_LIGHTS = 5;
-const int MAX_SPOT_LIGHTS = 5;
+const int MAX_SHADOWED_LIGHTS = 10;
+const int MAX_SHADOW_CASCADES = 4;
+const int MAX_SHADOW_TILES = MAX_SHADOWED_LIGHTS * 6;
+const int LIGHT_DATA_TEXELS = 5; //Texels per light in s_lightData
+const int CLUSTER_GRID_X = 16; //Has to match CommonValues.h
+const int CLUSTER_GRID_Y = 9;
+const int CLUSTER_GRID_Z = 24;
+const float EVSM_POSITIVE_EXPONENT = 5.54; //Has to match evsm_prefilter_fragment.shader
+const float EVSM_NEGATIVE_EXPONENT = 5.54;
+const float EVSM_LIGHT_BLEEDING_REDUCTION = 0.3;
 vec3 normal;
 
 struct Light
@@ -48,8 +56,10 @@ struct SpotLight
 
 struct OmniShadowMap
 {
-	samplerCube shadowMap;
+	int tile; //First atlas tile of the light, -1 when light has no shadows
+	int tileCount; //6 - cube faces of point light (+X, -X, +Y, -Y, +Z, -Z), 2 - dual paraboloid of point light (+Y, -Y), 1 - perspective shadow of spot light
 	float farPlane;
+	int prefiltered; //1 - EVSM moments are sampled instead of PCF of depth
 };
 
 struct Material
@@ -58,21 +68,33 @@ struct Material
 	float shininess;
 };
 
-//Light count
-uniform int u_pointLightCount;
-uniform int u_spotLightCount;
-
 //Lights
 uniform DirectionalLight u_directionalLight;
-uniform PointLight u_pointLights[MAX_POINT_LIGHTS];
-uniform SpotLight u_spotLights[MAX_SPOT_LIGHTS];
+
+//Clustered point and spot lights
+uniform samplerBuffer s_lightData; //LIGHT_DATA_TEXELS per light (position + shadow tile, color + ambient, diffuse + attenuation, direction + edge, shadow parameters)
+uniform usamplerBuffer s_clusterGrid; //Offset into s_clusterLightIndices and light count of each cluster
+uniform usamplerBuffer s_clusterLightIndices;
+uniform vec2 u_clusterTileSize; //In pixels
+uniform float u_clusterScale; //Depth slice = log(view depth) * u_clusterScale + u_clusterBias
+uniform float u_clusterBias;
 
 
 uniform sampler2D s_textureDiffuse; //Sampler that uses current Texture Unit (GL_TEXTURE1)
 uniform sampler2D s_textureNormal; //Sampler that uses current Texture Unit (GL_TEXTURE2)
 
-uniform sampler2D s_directionalShadowMap; //Shadow map Texture Unit (GL_TEXTURE1)
-uniform OmniShadowMap u_omniShadowMaps[MAX_POINT_LIGHTS + MAX_SPOT_LIGHTS];
+uniform sampler2DArray s_directionalShadowMap; //Cascaded shadow map, one layer per cascade
+uniform mat4 u_directionalLightTransforms[MAX_SHADOW_CASCADES]; //Projection * view of each cascade
+uniform float u_cascadeSplits[MAX_SHADOW_CASCADES]; //View depth where each cascade ends
+uniform int u_cascadeCount;
+uniform sampler2D s_shadowAtlas; //Depth of all point and spot light shadows
+uniform sampler2D s_shadowMomentsAtlas; //Blurred EVSM moments of lights with prefiltered shadows
+
+layout (std140) uniform ShadowTiles
+{
+	vec4 u_shadowTileRects[MAX_SHADOW_TILES]; //xy - offset, zw - size (in atlas uv)
+	mat4 u_shadowTileMatrices[MAX_SHADOW_TILES]; //Projection * view of the light for each tile
+};
 
 
 uniform Material u_material;
@@ -90,6 +112,75 @@ vec3 gridSamplingDisk[20] = vec3[] //Offset directions for 20 samples for PCF ed
 
 // ----------------------- Common -----------------------------
 
+vec2 ShadowAtlasCoords(int tile, vec2 tileCoords, vec2 atlasSize) //Position in the atlas of tileCoords [0;1] inside of the tile
+{
+	vec4 rect = u_shadowTileRects[tile];
+	vec2 halfTexel = 0.5 / atlasSize;
+	return clamp(rect.xy + tileCoords * rect.zw, rect.xy + halfTexel, rect.xy + rect.zw - halfTexel); //Do not sample neighbour tiles
+}
+
+float SampleShadowTile(int tile, vec2 tileCoords) //Depth stored in the atlas tile at tileCoords [0;1]
+{
+	return texture(s_shadowAtlas, ShadowAtlasCoords(tile, tileCoords, vec2(textureSize(s_shadowAtlas, 0)))).r;
+}
+
+vec4 SampleMomentsTile(int tile, vec2 tileCoords) //Prefiltered EVSM moments stored in the tile (same layout as depth atlas, lower resolution)
+{
+	return texture(s_shadowMomentsAtlas, ShadowAtlasCoords(tile, tileCoords, vec2(textureSize(s_shadowMomentsAtlas, 0))));
+}
+
+int CubeFace(vec3 direction) //Cube map face that direction points to (same order as cube map layers)
+{
+	vec3 absDirection = abs(direction);
+	if (absDirection.x >= absDirection.y && absDirection.x >= absDirection.z)
+	{
+		return direction.x > 0.0 ? 0 : 1;
+	}
+	if (absDirection.y >= absDirection.z)
+	{
+		return direction.y > 0.0 ? 2 : 3;
+	}
+	return direction.z > 0.0 ? 4 : 5;
+}
+
+vec2 ShadowTileCoords(OmniShadowMap shadowMap, vec3 lightPosition, vec3 direction, out int tile) //Tile that direction from the light points to and coordinates [0;1] inside of it
+{
+	int firstTile = shadowMap.tile;
+	int tileCount = shadowMap.tileCount;
+
+	if (tileCount == 2) //Dual paraboloid
+	{
+		tile = firstTile;
+		vec3 lightSpaceDirection = normalize(mat3(u_shadowTileMatrices[tile]) * direction);
+		if (lightSpaceDirection.z > 0.0) //Behind first hemisphere
+		{
+			tile = firstTile + 1;
+			lightSpaceDirection = normalize(mat3(u_shadowTileMatrices[tile]) * direction);
+		}
+		return (lightSpaceDirection.xy / (1.0 - lightSpaceDirection.z)) * 0.5 + 0.5; //Same projection as paraboloid shadow vertex shader
+	}
+
+	tile = tileCount == 6 ? firstTile + CubeFace(direction) : firstTile;
+	vec4 lightSpacePos = u_shadowTileMatrices[tile] * vec4(lightPosition + direction, 1.0);
+	return (lightSpacePos.xy / lightSpacePos.w) * 0.5 + 0.5;
+}
+
+vec2 WarpDepth(float depth) //Exponential warp of depth [0;1] used by EVSM (positive and negative)
+{
+	depth = depth * 2.0 - 1.0;
+	return vec2(exp(EVSM_POSITIVE_EXPONENT * depth), -exp(-EVSM_NEGATIVE_EXPONENT * depth));
+}
+
+float ChebyshevUpperBound(vec2 moments, float depth) //Upper bound of probability that surface at depth is lit
+{
+	if (depth <= moments.x) { return 1.0; }
+
+	float variance = max(moments.y - moments.x * moments.x, 0.00001);
+	float d = depth - moments.x;
+	float pMax = variance / (variance + d * d);
+	return clamp((pMax - EVSM_LIGHT_BLEEDING_REDUCTION) / (1.0 - EVSM_LIGHT_BLEEDING_REDUCTION), 0.0, 1.0); //Cut off tail that causes light bleeding
+}
+
 
 
 
@@ -119,21 +210,39 @@ vec4 CalcLightByDirection(Light light, vec3 direction, float shadowFactor) //All
 	return (ambientColour + (1.0 - shadowFactor) * (diffuseColour + specularColour));
 }
 
-float CalcPointShadowFactor(PointLight light, int shadowIndex)
+float CalcPointShadowFactor(PointLight light, OmniShadowMap shadowMap)
 {
 
+	if (shadowMap.tile < 0) //No space in the atlas or light does not need shadows
+	{
+		return 0.0;
+	}
+
 	vec3 fragToLight = v_fragPos - light.position; //Vector from frag to light source
 	float currentDepth = length(fragToLight); //Distance(depth) from the light to hitpoint(fragment position)
 
-	float shadow = 0.0;
 	float bias = 0.15;
+
+	if (shadowMap.prefiltered != 0) //One filtered fetch instead of PCF
+	{
+		int tile;
+		vec2 tileCoords = ShadowTileCoords(shadowMap, light.position, fragToLight, tile);
+		vec4 moments = SampleMomentsTile(tile, tileCoords);
+		vec2 warpedDepth = WarpDepth((currentDepth - bias) / shadowMap.farPlane);
+		float lit = min(ChebyshevUpperBound(moments.xy, warpedDepth.x), ChebyshevUpperBound(moments.zw, warpedDepth.y));
+		return 1.0 - lit;
+	}
+
+	float shadow = 0.0;
 	int samples = 20; //PCF samples
 	float viewDistance = length(u_cameraPosition - v_fragPos); //Distance between camera and fragment. To make sampling dynamic (make shadows smoothing depend on camera position)
-	float diskRadius = (1.0 + (viewDistance / u_omniShadowMaps[shadowIndex].farPlane)) / 25.0; //How far from fragment in sample direction(gridSamplingDisk) we want to sample (in pixels of map)
+	float diskRadius = (1.0 + (viewDistance / shadowMap.farPlane)) / 25.0; //How far from fragment in sample direction(gridSamplingDisk) we want to sample (in pixels of map)
 	for (int i = 0; i < samples; ++i)
 	{
-		float closestDepth = texture(u_omniShadowMaps[shadowIndex].shadowMap, fragToLight + gridSamplingDisk[i] * diskRadius).r; //Get distance from light source to point on shadow map in direction to frag + offset for sample
-		closestDepth *= u_omniShadowMaps[shadowIndex].farPlane;   // Undo mapping [0;1]
+		int tile;
+		vec2 tileCoords = ShadowTileCoords(shadowMap, light.position, fragToLight + gridSamplingDisk[i] * diskRadius, tile);
+		float closestDepth = SampleShadowTile(tile, tileCoords); //Get distance from light source to point on shadow map in direction to frag + offset for sample
+		closestDepth *= shadowMap.farPlane;   // Undo mapping [0;1]
 		if (currentDepth - bias > closestDepth) // If current(distance from the light source to fragment) - bias is greather than distance from the light source to the fragment depth value on the shadow map then fragment is in shadow
 		{
 			shadow += 1.0;
@@ -144,13 +253,13 @@ float CalcPointShadowFactor(PointLight light, int shadowIndex)
 	return shadow;
 }
 
-vec4 CalcPointLight(PointLight pLight, int shadowIndex)
+vec4 CalcPointLight(PointLight pLight, OmniShadowMap shadowMap)
 {
 	vec3 direction = v_fragPos - pLight.position; //Direction from light to fragment
 	float distance = length(direction);
 	direction = normalize(direction);
 
-	float shadowFactor = CalcPointShadowFactor(pLight, shadowIndex); //Where shadow should be
+	float shadowFactor = CalcPointShadowFactor(pLight, shadowMap); //Where shadow should be
 
 	vec4 color = CalcLightByDirection(pLight.base, direction, shadowFactor);
 	float attenuation = pLight.exponent * distance * distance + pLight.linear * distance + pLight.constant; //Over distance attenuation
@@ -160,9 +269,24 @@ vec4 CalcPointLight(PointLight pLight, int shadowIndex)
 
 // ------------------- Directional light ------------------------
 
-float CalcDirectionalShadowFactor(vec4 v_directionalLightSpacePos) //Directional shadows only
+float CalcDirectionalShadowFactor() //Directional shadows only
 {
-	vec3 projCoords = v_directionalLightSpacePos.xyz / v_directionalLightSpacePos.w; //Convert coordinates in relation to the light source to the normalized device coodinates (they will be between -1 and 1)
+	int cascade = -1;
+	for (int i = 0; i < u_cascadeCount; i++) //First cascade that reaches the fragment
+	{
+		if (v_viewDepth < u_cascadeSplits[i])
+		{
+			cascade = i;
+			break;
+		}
+	}
+	if (cascade == -1) //Further than shadow distance
+	{
+		return 0.0;
+	}
+
+	vec4 directionalLightSpacePos = u_directionalLightTransforms[cascade] * vec4(v_fragPos, 1.0); //Where position of a fragment is relative to the light (light point of view)
+	vec3 projCoords = directionalLightSpacePos.xyz / directionalLightSpacePos.w; //Convert coordinates in relation to the light source to the normalized device coodinates (they will be between -1 and 1)
 	projCoords = (projCoords * 0.5) + 0.5; //Convert the range to 0 and 1
 
 	float currentDepth = projCoords.z; //Distance(depth) from the light to hitpoint(fragment position)
@@ -173,12 +297,12 @@ float CalcDirectionalShadowFactor(vec4 v_directionalLightSpacePos) //Directional
 	float bias = max(0.005 * (1.0 - dot(normal, lightDir)), 0.0005);
 
 	float shadow = 0.0; //Shadow value used in Percentage Close to Filtering edges smoothing method
-	vec2 texelSize = 1.0 / textureSize(s_directionalShadowMap, 0); //Calculate texel size
+	vec2 texelSize = 1.0 / vec2(textureSize(s_directionalShadowMap, 0).xy); //Calculate texel size
 	for (int x = -1; x <= 1; ++x) //9 samples (calculations), one for each neighbour pixel
 	{
 		for (int y = -1; y <= 1; ++y)
 		{
-			float pcfDepth = texture(s_directionalShadowMap, projCoords.xy + vec2(x, y) * texelSize).r; //Get the value on the shadow map from the light source position (xy is point on plane that is cast orthogonally on shadow map)
+			float pcfDepth = texture(s_directionalShadowMap, vec3(projCoords.xy + vec2(x, y) * texelSize, float(cascade))).r; //Get the value on the shadow map from the light source position (xy is point on plane that is cast orthogonally on shadow map)
 			shadow += currentDepth - bias > pcfDepth ? 1.0 : 0.0; //If current(distance from the light source to fragment) - bias is greather than distance from the light source to the fragment depth value on the shadow map then fragment is in shadow
 		}
 	}
@@ -193,37 +317,22 @@ float CalcDirectionalShadowFactor(vec4 v_directionalLightSpacePos) //Directional
 	return shadow;
 }
 
-vec4 CalcDirectionalLight(vec4 v_directionalLightSpacePos)
+vec4 CalcDirectionalLight()
 {
-	float shadowFactor = CalcDirectionalShadowFactor(v_directionalLightSpacePos); //Calculate where shadow should be + PCF
+	float shadowFactor = CalcDirectionalShadowFactor(); //Calculate where shadow should be + PCF
 	return CalcLightByDirection(u_directionalLight.base, u_directionalLight.direction, shadowFactor); //Calculate how light affects object in areas where shadow should be
 }
 
-// --------------------- Point lights ---------------------------
-
-vec4 CalcPointLights()
-{
-	vec4 totalColour = vec4(0, 0, 0, 0);
-	for (int i = 0; i < u_pointLightCount; i++)
-	{
-		totalColour += CalcPointLight(u_pointLights[i], i);
-	}
-
-	return totalColour; //Return color, affected by all lights
-}
-
 // --------------------- Spot lights ---------------------------
 
-vec4 CalcSpotLight(SpotLight sLight, int shadowIndex)
+vec4 CalcSpotLight(SpotLight sLight, OmniShadowMap shadowMap)
 {
 	vec3 rayDirection = normalize(v_fragPos - sLight.base.position);
 	float slFactor = dot(rayDirection, sLight.direction); //Factor that indicates if fragment is in spotLight's cone
 
-	vec4 color = CalcPointLight(sLight.base, shadowIndex);
-
 	if (slFactor > sLight.edge)
 	{
-		vec4 color = CalcPointLight(sLight.base, shadowIndex);
+		vec4 color = CalcPointLight(sLight.base, shadowMap);
 
 		return color * (1.0f - (1.0f - slFactor)*(1.0f / (1.0f - sLight.edge))); //In cone
 	}
@@ -233,12 +342,37 @@ vec4 CalcSpotLight(SpotLight sLight, int shadowIndex)
 	}
 }
 
-vec4 CalcSpotLights()
+// ------------------ Clustered lights -------------------------
+
+vec4 CalcClusteredLights() //Point and spot lights assigned to the cluster of this fragment
 {
+	ivec2 tile = ivec2(gl_FragCoord.xy / u_clusterTileSize);
+	int slice = clamp(int(log(max(v_viewDepth, 0.0001)) * u_clusterScale + u_clusterBias), 0, CLUSTER_GRID_Z - 1);
+	int cluster = tile.x + tile.y * CLUSTER_GRID_X + slice * CLUSTER_GRID_X * CLUSTER_GRID_Y;
+	uvec2 clusterLights = texelFetch(s_clusterGrid, cluster).rg; //Offset, count
+
 	vec4 totalColour = vec4(0, 0, 0, 0);
-	for (int i = 0; i < u_spotLightCount; i++)
+	for (uint i = 0u; i < clusterLights.y; i++)
 	{
-		totalColour += CalcSpotLight(u_spotLights[i], i + u_pointLightCount);
+		int lightIndex = int(texelFetch(s_clusterLightIndices, int(clusterLights.x + i)).r);
+		int base = lightIndex * LIGHT_DATA_TEXELS;
+		vec4 positionTile = texelFetch(s_lightData, base);
+		vec4 colorAmbient = texelFetch(s_lightData, base + 1);
+		vec4 diffuseAttenuation = texelFetch(s_lightData, base + 2);
+		vec4 directionEdge = texelFetch(s_lightData, base + 3);
+		vec4 shadowParameters = texelFetch(s_lightData, base + 4);
+
+		PointLight pointLight = PointLight(Light(colorAmbient.rgb, colorAmbient.a, diffuseAttenuation.x), positionTile.xyz, diffuseAttenuation.y, diffuseAttenuation.z, diffuseAttenuation.w);
+		OmniShadowMap shadowMap = OmniShadowMap(int(positionTile.w), int(shadowParameters.x), shadowParameters.y, int(shadowParameters.z));
+
+		if (directionEdge.w < -1.0) //Point light
+		{
+			totalColour += CalcPointLight(pointLight, shadowMap);
+		}
+		else
+		{
+			totalColour += CalcSpotLight(SpotLight(pointLight, directionEdge.xyz, directionEdge.w), shadowMap);
+		}
 	}
 
 	return totalColour;
@@ -253,9 +387,8 @@ void main()
 	normal = normalize(normal * 2.0 - 1.0);
 	normal = normalize(v_TBN * normal);
 
-	vec4 finalColour = CalcDirectionalLight(v_directionalLightSpacePos);
-	finalColour += CalcPointLights();
-	finalColour += CalcSpotLights();
+	vec4 finalColour = CalcDirectionalLight();
+	finalColour += CalcClusteredLights();
 
 	color = texture(s_textureDiffuse, v_texCoords) * finalColour; //Final color of texture affected by light
 }
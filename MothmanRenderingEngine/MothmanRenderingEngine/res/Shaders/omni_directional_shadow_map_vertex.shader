@@ -1,9 +1,13 @@
 #version 330
 layout (location = 0) in vec3 pos;
+layout (location = 4) in mat4 model; //Per-instance model matrix
 
-uniform mat4 u_model;
+uniform mat4 u_lightMatrix; //Projection * view of the cube map face that is being rendered
+
+out vec4 v_fragPos;
 
 void main()
 {
-	gl_Position = u_model * vec4(pos, 1.0);
-}
\ No newline at end of file
+	v_fragPos = model * vec4(pos, 1.0); //World position, fragment shader needs distance from the light
+	gl_Position = u_lightMatrix * v_fragPos;
+}
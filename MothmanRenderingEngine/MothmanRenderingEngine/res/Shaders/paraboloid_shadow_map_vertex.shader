@@ -0,0 +1,21 @@
+#version 330
+layout (location = 0) in vec3 pos;
+layout (location = 4) in mat4 model; //Per-instance model matrix
+
+uniform mat4 u_lightView; //View of the hemisphere that is being rendered (looks along -Z)
+uniform float u_farPlane;
+
+out vec4 v_fragPos;
+out float gl_ClipDistance[1];
+
+void main()
+{
+	v_fragPos = model * vec4(pos, 1.0); //World position, fragment shader needs distance from the light
+
+	vec3 lightSpacePos = (u_lightView * v_fragPos).xyz;
+	float distance = length(lightSpacePos);
+	vec3 direction = lightSpacePos / distance;
+
+	gl_ClipDistance[0] = -direction.z; //Clip everything behind the hemisphere
+	gl_Position = vec4(direction.xy / (1.0 - direction.z), distance / u_farPlane * 2.0 - 1.0, 1.0); //Paraboloid projection, depth is overwritten by fragment shader
+}
@@ -5,8 +5,10 @@ layout(location = 1) in vec2 tex;
 
 out vec2 v_texCoords;
 
+uniform vec2 u_uvScale = vec2(1.0); //Part of the input texture that is covered by the image (render graph textures are rounded up in size)
+
 void main()
 {
 	gl_Position = vec4(pos.x, pos.y, 0.0, 1.0);
-	v_texCoords = tex;
-}
\ No newline at end of file
+	v_texCoords = tex * u_uvScale;
+}
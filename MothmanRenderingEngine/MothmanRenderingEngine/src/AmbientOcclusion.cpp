@@ -0,0 +1,80 @@
+#include "AmbientOcclusion.h"
+
+#include "RenderStats.h"
+#include "GLState.h"
+
+AmbientOcclusion::AmbientOcclusion()
+{
+	UBO = 0;
+	noiseTexture = 0;
+	kernelSize = 0;
+}
+
+bool AmbientOcclusion::Init()
+{
+	glGenBuffers(1, &UBO);
+	GLState::BindBuffer(GL_UNIFORM_BUFFER, UBO);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(KernelBlock), nullptr, GL_STATIC_DRAW);
+	GLState::BindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, SSAO_KERNEL_UBO_BINDING, UBO);
+
+	//Random kernel rotations around normal (texture tiled over the screen)
+	std::uniform_real_distribution<float> randomFloats(0.0f, 1.0f);
+	std::vector<glm::vec3> noise;
+	for (int i = 0; i < SSAO_NOISE_SIZE * SSAO_NOISE_SIZE; i++)
+	{
+		noise.push_back(glm::vec3(randomFloats(generator) * 2.0f - 1.0f, randomFloats(generator) * 2.0f - 1.0f, 0.0f));
+	}
+
+	glGenTextures(1, &noiseTexture);
+	GLState::BindTexture(GL_TEXTURE_2D, noiseTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, SSAO_NOISE_SIZE, SSAO_NOISE_SIZE, 0, GL_RGB, GL_FLOAT, &noise[0]);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	GLState::BindTexture(GL_TEXTURE_2D, 0);
+
+	return true;
+}
+
+void AmbientOcclusion::SetKernelSize(int sampleCount)
+{
+	sampleCount = glm::clamp(sampleCount, 1, SSAO_MAX_SAMPLES_PER_KERNEL);
+	if (sampleCount == kernelSize)
+	{
+		return;
+	}
+	kernelSize = sampleCount;
+
+	//Random samples in hemisphere around +z, distributed over whole count so that fewer samples still cover the radius
+	std::uniform_real_distribution<float> randomFloats(0.0f, 1.0f);
+	KernelBlock kernelBlock = {};
+	for (int i = 0; i < kernelSize; i++)
+	{
+		glm::vec3 sample(randomFloats(generator) * 2.0f - 1.0f, randomFloats(generator) * 2.0f - 1.0f, randomFloats(generator));
+		sample = glm::normalize(sample) * randomFloats(generator);
+		float scale = (float)i / kernelSize;
+		scale = 0.1f + scale * scale * 0.9f; //Move samples closer to origin of the hemisphere
+		kernelBlock.samples[i] = glm::vec4(sample * scale, 0.0f);
+	}
+
+	GLState::BindBuffer(GL_UNIFORM_BUFFER, UBO);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(KernelBlock), &kernelBlock);
+	RenderStats::Add(RENDER_STAT_BUFFER_UPLOAD_BYTES, sizeof(KernelBlock));
+	GLState::BindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+AmbientOcclusion::~AmbientOcclusion()
+{
+	if (UBO)
+	{
+		glDeleteBuffers(1, &UBO);
+		GLState::ForgetBuffer(UBO);
+	}
+	if (noiseTexture)
+	{
+		glDeleteTextures(1, &noiseTexture);
+		GLState::ForgetTexture(noiseTexture);
+	}
+}
@@ -0,0 +1,50 @@
+/*
+Screen space ambient occlusion
+
+Occlusion is computed at reduced resolution (screen size / divisor) from view space normals and linear view depth written by depth pass.
+Hemisphere kernel lives in a uniform block (SSAOKernel) and is regenerated only when sample count changes,
+4x4 noise texture with kernel rotations is created once. Occlusion and blur targets are render graph textures.
+
+Passes:
+- occlusion: kernel samples around every low resolution pixel, output is occlusion (r) and view depth of the pixel (g)
+- blur: 4x4 box blur (size of the noise tile) that ignores neighbours with different depth, so occlusion doesn't leak over edges
+- upsample: full resolution pass picks from 4 nearest low resolution pixels weighted by bilinear weight and depth similarity, and darkens the screen
+Depth is stored next to occlusion, so blur and upsample don't need to read depth buffer again.
+*/
+
+#pragma once
+
+#include <stdio.h>
+#include <vector>
+#include <random>
+
+#include <GL\glew.h>
+#include <glm\glm.hpp>
+
+#include "CommonValues.h"
+
+class AmbientOcclusion
+{
+public:
+	AmbientOcclusion();
+
+	bool Init();
+	void SetKernelSize(int sampleCount); //Regenerate and upload kernel when sample count changed
+
+	GLuint GetNoiseTexture() { return noiseTexture; }
+	int GetKernelSize() { return kernelSize; }
+
+	~AmbientOcclusion();
+
+private:
+	struct KernelBlock //std140 layout of SSAOKernel uniform block
+	{
+		glm::vec4 samples[SSAO_MAX_SAMPLES_PER_KERNEL]; //xyz - sample in tangent space hemisphere
+	};
+
+	GLuint UBO;
+	GLuint noiseTexture;
+	int kernelSize;
+
+	std::default_random_engine generator;
+};
@@ -0,0 +1,181 @@
+#include "Benchmark.h"
+
+Benchmark::Benchmark()
+{
+}
+
+void Benchmark::AddFrame(float frameTime, FrameTimer* timer, const RenderQueueStats& stats)
+{
+	FrameSample sample;
+	sample.frameTime = frameTime;
+	sample.cpuTime = timer->GetFrameCPUSample();
+	sample.stats = stats;
+	for (int stat = 0; stat < RENDER_STAT_COUNT; stat++) { sample.renderStats.values[stat] = timer->GetFrameStat((RenderStat)stat); }
+	frames.push_back(sample);
+
+	for (unsigned int i = 0; i < timer->GetSectionCount(); i++)
+	{
+		SectionTiming& section = GetSection(timer->GetSectionName(i));
+		float time;
+		if (timer->GetSectionCPUSample(i, time))
+		{
+			section.cpuSum += time;
+			section.cpuCount++;
+			for (int stat = 0; stat < RENDER_STAT_COUNT; stat++) { section.statSums[stat] += (double)timer->GetSectionStat(i, (RenderStat)stat); }
+		}
+		if (timer->GetSectionGPUSample(i, time))
+		{
+			section.gpuSum += time;
+			section.gpuCount++;
+		}
+	}
+}
+
+float Benchmark::GetPercentile(float percentile)
+{
+	if (frames.empty())
+	{
+		return 0.0f;
+	}
+
+	std::vector<float> times(frames.size());
+	for (size_t i = 0; i < frames.size(); i++) { times[i] = frames[i].frameTime; }
+	size_t rank = (size_t)ceil(percentile / 100.0 * times.size()); //Nearest rank, 1 based
+	rank = std::min(std::max(rank, (size_t)1), times.size());
+	std::nth_element(times.begin(), times.begin() + (rank - 1), times.end());
+	return times[rank - 1];
+}
+
+float Benchmark::GetAverageFrameTime()
+{
+	double sum = 0.0;
+	for (size_t i = 0; i < frames.size(); i++) { sum += frames[i].frameTime; }
+	return frames.empty() ? 0.0f : (float)(sum / frames.size());
+}
+
+bool Benchmark::WriteReport(const std::string& path, const std::string& description)
+{
+	bool written = WriteCSV(path + ".csv") && WriteJSON(path + ".json", description);
+	if (written)
+	{
+		printf("LOG: Benchmark: %d frames, average %.3f ms, p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, report %s.csv/.json\n",
+			GetFrameCount(), GetAverageFrameTime(), GetPercentile(50.0f), GetPercentile(95.0f), GetPercentile(99.0f), path.c_str());
+	}
+	return written;
+}
+
+std::string Benchmark::EscapeJSON(const std::string& text)
+{
+	std::string escaped;
+	for (size_t i = 0; i < text.size(); i++)
+	{
+		if (text[i] == '"' || text[i] == '\\') { escaped += '\\'; }
+		escaped += text[i];
+	}
+	return escaped;
+}
+
+Benchmark::SectionTiming& Benchmark::GetSection(const std::string& name)
+{
+	std::unordered_map<std::string, int>::iterator found = sectionIndices.find(name);
+	if (found != sectionIndices.end())
+	{
+		return sections[found->second];
+	}
+
+	SectionTiming section;
+	section.name = name;
+	section.cpuSum = 0.0;
+	section.gpuSum = 0.0;
+	section.cpuCount = 0;
+	section.gpuCount = 0;
+	for (int stat = 0; stat < RENDER_STAT_COUNT; stat++) { section.statSums[stat] = 0.0; }
+	sectionIndices[name] = (int)sections.size();
+	sections.push_back(section);
+	return sections.back();
+}
+
+bool Benchmark::WriteCSV(const std::string& fileLocation)
+{
+	FILE* file = fopen(fileLocation.c_str(), "w");
+	if (file == nullptr)
+	{
+		printf("ERROR: Could not open %s for writing\n", fileLocation.c_str());
+		return false;
+	}
+
+	fprintf(file, "frame,frame_ms,cpu_ms,draw_calls,instances,mesh_binds,material_changes,texture_binds");
+	for (int stat = 0; stat < RENDER_STAT_COUNT; stat++) { fprintf(file, ",gl_%s", RenderStats::GetStatKey((RenderStat)stat)); }
+	fprintf(file, "\n");
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		const FrameSample& frame = frames[i];
+		fprintf(file, "%d,%.4f,%.4f,%u,%u,%u,%u,%u", (int)i, frame.frameTime, frame.cpuTime,
+			frame.stats.drawCalls, frame.stats.instances, frame.stats.meshBinds, frame.stats.materialChanges, frame.stats.textureBinds);
+		for (int stat = 0; stat < RENDER_STAT_COUNT; stat++) { fprintf(file, ",%llu", frame.renderStats.values[stat]); }
+		fprintf(file, "\n");
+	}
+	fclose(file);
+	return true;
+}
+
+bool Benchmark::WriteJSON(const std::string& fileLocation, const std::string& description)
+{
+	FILE* file = fopen(fileLocation.c_str(), "w");
+	if (file == nullptr)
+	{
+		printf("ERROR: Could not open %s for writing\n", fileLocation.c_str());
+		return false;
+	}
+
+	float minTime = 0.0f, maxTime = 0.0f;
+	double drawCalls = 0.0, instances = 0.0, meshBinds = 0.0, materialChanges = 0.0, textureBinds = 0.0;
+	double renderStats[RENDER_STAT_COUNT] = {};
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		const FrameSample& frame = frames[i];
+		minTime = i == 0 ? frame.frameTime : std::min(minTime, frame.frameTime);
+		maxTime = std::max(maxTime, frame.frameTime);
+		drawCalls += frame.stats.drawCalls;
+		instances += frame.stats.instances;
+		meshBinds += frame.stats.meshBinds;
+		materialChanges += frame.stats.materialChanges;
+		textureBinds += frame.stats.textureBinds;
+		for (int stat = 0; stat < RENDER_STAT_COUNT; stat++) { renderStats[stat] += (double)frame.renderStats.values[stat]; }
+	}
+	double frameCount = frames.empty() ? 1.0 : (double)frames.size();
+
+	fprintf(file, "{\n");
+	fprintf(file, "  \"run\": { %s },\n", description.c_str());
+	fprintf(file, "  \"frames\": %d,\n", GetFrameCount());
+	fprintf(file, "  \"frame_ms\": { \"average\": %.4f, \"min\": %.4f, \"max\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f },\n",
+		GetAverageFrameTime(), minTime, maxTime, GetPercentile(50.0f), GetPercentile(95.0f), GetPercentile(99.0f));
+	fprintf(file, "  \"average_counters\": { \"draw_calls\": %.2f, \"instances\": %.2f, \"mesh_binds\": %.2f, \"material_changes\": %.2f, \"texture_binds\": %.2f },\n",
+		drawCalls / frameCount, instances / frameCount, meshBinds / frameCount, materialChanges / frameCount, textureBinds / frameCount);
+	fprintf(file, "  \"average_render_stats\": { ");
+	for (int stat = 0; stat < RENDER_STAT_COUNT; stat++)
+	{
+		fprintf(file, "\"%s\": %.2f%s", RenderStats::GetStatKey((RenderStat)stat), renderStats[stat] / frameCount, stat + 1 < RENDER_STAT_COUNT ? ", " : " },\n");
+	}
+	fprintf(file, "  \"sections\": [\n");
+	for (size_t i = 0; i < sections.size(); i++)
+	{
+		const SectionTiming& section = sections[i];
+		double sectionFrames = section.cpuCount > 0 ? (double)section.cpuCount : 1.0;
+		fprintf(file, "    { \"name\": \"%s\", \"frames\": %u, \"cpu_ms\": %.4f, \"gpu_ms\": %.4f, \"render_stats\": { ", EscapeJSON(section.name).c_str(), section.cpuCount,
+			section.cpuCount > 0 ? section.cpuSum / section.cpuCount : 0.0, section.gpuCount > 0 ? section.gpuSum / section.gpuCount : 0.0);
+		for (int stat = 0; stat < RENDER_STAT_COUNT; stat++)
+		{
+			fprintf(file, "\"%s\": %.2f%s", RenderStats::GetStatKey((RenderStat)stat), section.statSums[stat] / sectionFrames, stat + 1 < RENDER_STAT_COUNT ? ", " : " } }");
+		}
+		fprintf(file, "%s\n", i + 1 < sections.size() ? "," : "");
+	}
+	fprintf(file, "  ]\n");
+	fprintf(file, "}\n");
+	fclose(file);
+	return true;
+}
+
+Benchmark::~Benchmark()
+{
+}
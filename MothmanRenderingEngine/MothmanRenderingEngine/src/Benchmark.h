@@ -0,0 +1,63 @@
+/*
+Benchmark
+
+Collects measured frames of a headless run (warm-up frames are not added) and writes report:
+- <path>.csv: one row per frame - frame time (wall clock between frame starts, image writes excluded), CPU time of the frame and
+  render queue counters (draw calls, instances, mesh binds, material changes, texture binds) and render stats of the frame (gl_ columns)
+- <path>.json: run description, frame time average/min/max and p50/p95/p99 (nearest rank), average counters and render stats
+  and average CPU/GPU time and render stats of every frame timer section (render graph passes, shadows, terrain)
+GPU samples arrive FRAME_TIMER_LATENCY frames late, so the last few measured frames don't have GPU times of their own.
+*/
+
+#pragma once
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+
+#include "FrameTimer.h"
+#include "RenderQueue.h"
+
+class Benchmark
+{
+public:
+	Benchmark();
+
+	void AddFrame(float frameTime, FrameTimer* timer, const RenderQueueStats& stats); //After FrameTimer::EndFrame
+	bool WriteReport(const std::string& path, const std::string& description); //path without extension, description is JSON object body
+
+	unsigned int GetFrameCount() { return (unsigned int)frames.size(); }
+	float GetPercentile(float percentile); //Frame time in milliseconds
+	float GetAverageFrameTime();
+
+	static std::string EscapeJSON(const std::string& text); //Quotes and backslashes (Windows paths) escaped for JSON string
+
+	~Benchmark();
+
+private:
+	struct FrameSample
+	{
+		float frameTime, cpuTime;
+		RenderQueueStats stats;
+		RenderStatValues renderStats;
+	};
+
+	struct SectionTiming
+	{
+		std::string name;
+		double cpuSum, gpuSum;
+		double statSums[RENDER_STAT_COUNT]; //Added with CPU times, averaged by cpuCount
+		unsigned int cpuCount, gpuCount;
+	};
+
+	std::vector<FrameSample> frames;
+	std::vector<SectionTiming> sections;
+	std::unordered_map<std::string, int> sectionIndices;
+
+	SectionTiming& GetSection(const std::string& name);
+	bool WriteCSV(const std::string& fileLocation);
+	bool WriteJSON(const std::string& fileLocation, const std::string& description);
+};
@@ -2,6 +2,10 @@
 
 Camera::Camera()
 {
+	fieldOfView = 60.0f;
+	aspectRatio = 1.0f;
+	nearPlane = 0.1f;
+	farPlane = 100.0f;
 }
 
 Camera::Camera(glm::vec3 startPosition, glm::vec3 startUp, GLfloat startYaw, GLfloat startPitch, GLfloat startMoveSpeed, GLfloat startTurnSpeed)
@@ -16,6 +20,11 @@ Camera::Camera(glm::vec3 startPosition, glm::vec3 startUp, GLfloat startYaw, GLf
 	moveSpeed = startMoveSpeed;
 	turnSpeed = startTurnSpeed;
 
+	fieldOfView = 60.0f; //Until projection matrix is calculated
+	aspectRatio = 1.0f;
+	nearPlane = 0.1f;
+	farPlane = 100.0f;
+
 	Update();
 }
 
@@ -81,6 +90,14 @@ void Camera::MouseControl(bool* keys, bool* mouseButtons, GLfloat xChange, GLflo
 	*/
 }
 
+void Camera::SetPose(glm::vec3 position, GLfloat yaw, GLfloat pitch)
+{
+	this->position = position;
+	this->yaw = yaw;
+	this->pitch = pitch;
+	Update();
+}
+
 void Camera::CalculateViewMatrix()
 {
 	viewMatrix = glm::lookAt(position, position + forward, up);
@@ -88,10 +105,18 @@ void Camera::CalculateViewMatrix()
 
 void Camera::CalculateProjectionMatrix(float FOV, GLfloat windowBufferWidth, GLfloat windowBufferHeight, float nearPlane, float farPlane)
 {
-	projectionMatrix = glm::perspective(glm::radians(FOV), windowBufferWidth / windowBufferHeight, nearPlane, farPlane); //(field of view, aspect ratio, draw distance min, draw distance max)
+	fieldOfView = FOV;
+	aspectRatio = windowBufferWidth / windowBufferHeight;
+	this->nearPlane = nearPlane;
+	this->farPlane = farPlane;
+	projectionMatrix = glm::perspective(glm::radians(FOV), aspectRatio, nearPlane, farPlane); //(field of view, aspect ratio, draw distance min, draw distance max)
 }
 
 
+void Camera::CalculateFrustum()
+{
+	frustum.ExtractPlanes(projectionMatrix * viewMatrix);
+}
 
 void Camera::Update()
 {
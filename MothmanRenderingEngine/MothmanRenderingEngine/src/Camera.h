@@ -7,6 +7,8 @@
 
 #include <iostream>
 
+#include "Frustum.h"
+
 class Camera
 {
 public:
@@ -17,12 +19,22 @@ public:
 	void MouseControl(bool* keys, bool* mouseButtons, GLfloat xChange, GLfloat yChange, GLfloat deltaTime);
 
 	glm::vec3 GetCameraPosition() { return position; }
+	void SetPose(glm::vec3 position, GLfloat yaw, GLfloat pitch); //Place camera directly (camera path)
+	GLfloat GetYaw() { return yaw; }
+	GLfloat GetPitch() { return pitch; }
 
 	void CalculateViewMatrix();
 	glm::mat4 GetViewMatrix() { return viewMatrix; }
 
 	void CalculateProjectionMatrix(float FOV, GLfloat windowBufferWidth, GLfloat windowBufferHeight, float nearPlane, float farPlane);
 	glm::mat4 GetProjectionMatrix() { return projectionMatrix; }
+	float GetFOV() { return fieldOfView; } //In degrees
+	float GetAspectRatio() { return aspectRatio; }
+	float GetNearPlane() { return nearPlane; }
+	float GetFarPlane() { return farPlane; }
+
+	void CalculateFrustum(); //Call after view and projection matrices are calculated
+	const Frustum& GetFrustum() { return frustum; }
 
 	glm::vec3 GetForward() { return forward; }
 
@@ -32,6 +44,8 @@ private:
 
 	glm::mat4 viewMatrix;
 	glm::mat4 projectionMatrix;
+	Frustum frustum;
+	float fieldOfView, aspectRatio, nearPlane, farPlane; //Projection parameters (needed to split frustum for shadow cascades)
 
 	glm::vec3 position;
 	glm::vec3 forward;
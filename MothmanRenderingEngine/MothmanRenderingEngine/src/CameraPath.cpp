@@ -0,0 +1,121 @@
+#include "CameraPath.h"
+
+CameraPath::CameraPath()
+{
+}
+
+bool CameraPath::Load(const std::string& fileLocation)
+{
+	FILE* file = fopen(fileLocation.c_str(), "r");
+	if (file == nullptr)
+	{
+		printf("ERROR: Could not open camera path %s\n", fileLocation.c_str());
+		return false;
+	}
+
+	keyframes.clear();
+	char line[256];
+	int lineNumber = 0;
+	while (fgets(line, sizeof(line), file) != nullptr)
+	{
+		lineNumber++;
+		if (line[0] == '#' || line[0] == '\n' || line[0] == '\r')
+		{
+			continue;
+		}
+
+		Keyframe keyframe;
+		if (sscanf(line, "%f %f %f %f %f %f", &keyframe.time, &keyframe.position.x, &keyframe.position.y, &keyframe.position.z, &keyframe.yaw, &keyframe.pitch) != 6)
+		{
+			printf("ERROR: Camera path %s line %d: expected time x y z yaw pitch\n", fileLocation.c_str(), lineNumber);
+			fclose(file);
+			return false;
+		}
+		if (!keyframes.empty() && keyframe.time < keyframes.back().time)
+		{
+			printf("ERROR: Camera path %s line %d: keyframes are not sorted by time\n", fileLocation.c_str(), lineNumber);
+			fclose(file);
+			return false;
+		}
+		keyframes.push_back(keyframe);
+	}
+	fclose(file);
+
+	printf("LOG: Camera path %s: %d keyframes, %.2f s\n", fileLocation.c_str(), (int)keyframes.size(), GetDuration());
+	return !keyframes.empty();
+}
+
+bool CameraPath::Save(const std::string& fileLocation)
+{
+	FILE* file = fopen(fileLocation.c_str(), "w");
+	if (file == nullptr)
+	{
+		printf("ERROR: Could not open %s for writing\n", fileLocation.c_str());
+		return false;
+	}
+
+	fprintf(file, "# time x y z yaw pitch\n");
+	for (size_t i = 0; i < keyframes.size(); i++)
+	{
+		const Keyframe& keyframe = keyframes[i];
+		fprintf(file, "%.4f %.4f %.4f %.4f %.4f %.4f\n", keyframe.time, keyframe.position.x, keyframe.position.y, keyframe.position.z, keyframe.yaw, keyframe.pitch);
+	}
+	fclose(file);
+
+	printf("LOG: Camera path %s saved: %d keyframes, %.2f s\n", fileLocation.c_str(), (int)keyframes.size(), GetDuration());
+	return true;
+}
+
+void CameraPath::AddKeyframe(float time, glm::vec3 position, float yaw, float pitch)
+{
+	Keyframe keyframe;
+	keyframe.time = time;
+	keyframe.position = position;
+	keyframe.yaw = yaw;
+	keyframe.pitch = pitch;
+	keyframes.push_back(keyframe);
+}
+
+void CameraPath::CreateOrbit(glm::vec3 center, float radius, float height, float duration)
+{
+	keyframes.clear();
+	const int steps = 36; //Every 10 degrees, linear interpolation of yaw matches the circle closely enough
+	float pitch = -glm::degrees(atan2(height, radius)); //Looking down at center
+	for (int i = 0; i <= steps; i++)
+	{
+		float angle = glm::two_pi<float>() * i / steps;
+		glm::vec3 position = center + glm::vec3(radius * cos(angle), height, radius * sin(angle));
+		AddKeyframe(duration * i / steps, position, glm::degrees(angle) + 180.0f, pitch); //Yaw keeps growing, so interpolation doesn't jump at 360
+	}
+}
+
+void CameraPath::Sample(float time, glm::vec3& position, float& yaw, float& pitch)
+{
+	if (keyframes.empty())
+	{
+		return;
+	}
+
+	size_t next = 0;
+	while (next < keyframes.size() && keyframes[next].time <= time) { next++; }
+
+	if (next == 0 || next == keyframes.size()) //Before or after the path
+	{
+		const Keyframe& keyframe = keyframes[next == 0 ? 0 : next - 1];
+		position = keyframe.position;
+		yaw = keyframe.yaw;
+		pitch = keyframe.pitch;
+		return;
+	}
+
+	const Keyframe& a = keyframes[next - 1];
+	const Keyframe& b = keyframes[next];
+	float t = (time - a.time) / (b.time - a.time); //b.time > time >= a.time, so no division by zero
+	position = glm::mix(a.position, b.position, t);
+	yaw = glm::mix(a.yaw, b.yaw, t);
+	pitch = glm::mix(a.pitch, b.pitch, t);
+}
+
+CameraPath::~CameraPath()
+{
+}
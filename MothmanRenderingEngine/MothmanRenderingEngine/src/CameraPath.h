@@ -0,0 +1,44 @@
+/*
+Camera path
+
+Keyframes loaded from text file, one per line: time (seconds) position x y z yaw pitch (degrees, same as Camera).
+Lines starting with # are comments. Keyframes have to be sorted by time, camera is interpolated linearly between them
+and holds first/last keyframe before/after the path.
+Paths are recorded in windowed mode (AddKeyframe + Save) or generated (CreateOrbit) for benchmarks that don't need a file.
+*/
+
+#pragma once
+
+#include <stdio.h>
+#include <vector>
+#include <string>
+
+#include <glm\glm.hpp>
+#include <glm\gtc\constants.hpp>
+
+class CameraPath
+{
+public:
+	CameraPath();
+
+	bool Load(const std::string& fileLocation);
+	bool Save(const std::string& fileLocation);
+	void AddKeyframe(float time, glm::vec3 position, float yaw, float pitch); //Time has to be after last keyframe
+	void CreateOrbit(glm::vec3 center, float radius, float height, float duration); //One circle around center looking at it
+
+	bool IsEmpty() { return keyframes.empty(); }
+	float GetDuration() { return keyframes.empty() ? 0.0f : keyframes.back().time; }
+	void Sample(float time, glm::vec3& position, float& yaw, float& pitch);
+
+	~CameraPath();
+
+private:
+	struct Keyframe
+	{
+		float time;
+		glm::vec3 position;
+		float yaw, pitch;
+	};
+
+	std::vector<Keyframe> keyframes;
+};
@@ -0,0 +1,188 @@
+#include "CommandBuffer.h"
+
+#include <stdio.h>
+
+#include "GLState.h"
+#include "RenderStats.h"
+
+static const size_t COMMAND_ALIGNMENT = 8; //Every command size is rounded up to this, so commands are packed without padding
+
+CommandBuffer::CommandBuffer() : commands(COMMAND_BUFFER_BLOCK_SIZE), scratch(COMMAND_BUFFER_BLOCK_SIZE)
+{
+	commandCount = 0;
+	recordTime = 0.0f;
+	replayTime = 0.0f;
+	instanceBuffer = 0;
+}
+
+void CommandBuffer::Begin()
+{
+	commands.Reset();
+	scratch.Reset();
+	commandCount = 0;
+	recordBegin = Clock::now();
+}
+
+void CommandBuffer::End()
+{
+	recordTime = std::chrono::duration<float, std::milli>(Clock::now() - recordBegin).count();
+}
+
+void* CommandBuffer::AddCommand(CommandType type, size_t size)
+{
+	size = (size + COMMAND_ALIGNMENT - 1) & ~(COMMAND_ALIGNMENT - 1);
+	CommandHeader* header = (CommandHeader*)commands.Allocate(size, COMMAND_ALIGNMENT);
+	header->type = type;
+	header->size = (uint32_t)size;
+	commandCount++;
+	return header;
+}
+
+void CommandBuffer::BindProgram(GLuint program)
+{
+	CommandBindProgram* command = (CommandBindProgram*)AddCommand(COMMAND_BIND_PROGRAM, sizeof(CommandBindProgram));
+	command->program = program;
+}
+
+void CommandBuffer::BindUniformBufferRange(GLuint binding, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+	CommandBindUniformBufferRange* command = (CommandBindUniformBufferRange*)AddCommand(COMMAND_BIND_UNIFORM_BUFFER_RANGE, sizeof(CommandBindUniformBufferRange));
+	command->binding = binding;
+	command->buffer = buffer;
+	command->offset = (uint32_t)offset;
+	command->size = (uint32_t)size;
+}
+
+void CommandBuffer::BindVertexArray(GLuint vertexArray)
+{
+	CommandBindVertexArray* command = (CommandBindVertexArray*)AddCommand(COMMAND_BIND_VERTEX_ARRAY, sizeof(CommandBindVertexArray));
+	command->vertexArray = vertexArray;
+}
+
+void CommandBuffer::BindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+	CommandBindTexture* command = (CommandBindTexture*)AddCommand(COMMAND_BIND_TEXTURE, sizeof(CommandBindTexture));
+	command->unit = unit;
+	command->target = target;
+	command->texture = texture;
+}
+
+void CommandBuffer::SetUniform(GLint location, GLfloat value)
+{
+	CommandSetUniformFloat* command = (CommandSetUniformFloat*)AddCommand(COMMAND_SET_UNIFORM_FLOAT, sizeof(CommandSetUniformFloat));
+	command->location = location;
+	command->value = value;
+}
+
+glm::mat4* CommandBuffer::InstanceData(uint32_t instanceCount)
+{
+	CommandInstanceData* command = (CommandInstanceData*)AddCommand(COMMAND_INSTANCE_DATA, sizeof(CommandInstanceData) + sizeof(glm::mat4) * instanceCount);
+	command->instanceCount = instanceCount;
+	command->padding = 0;
+	return (glm::mat4*)(command + 1);
+}
+
+void CommandBuffer::DrawIndexedInstanced(GLsizei indexCount, GLsizei firstInstance, GLsizei instanceCount)
+{
+	CommandDrawIndexedInstanced* command = (CommandDrawIndexedInstanced*)AddCommand(COMMAND_DRAW_INDEXED_INSTANCED, sizeof(CommandDrawIndexedInstanced));
+	command->indexCount = indexCount;
+	command->firstInstance = firstInstance;
+	command->instanceCount = instanceCount;
+}
+
+void CommandBuffer::Execute()
+{
+	Clock::time_point replayBegin = Clock::now();
+
+	for (size_t block = 0; block < commands.GetBlockCount(); block++)
+	{
+		const uint8_t* data = commands.GetBlockData(block);
+		size_t used = commands.GetBlockUsed(block);
+		for (size_t offset = 0; offset < used; offset += ((const CommandHeader*)(data + offset))->size)
+		{
+			const CommandHeader* header = (const CommandHeader*)(data + offset);
+			switch (header->type)
+			{
+			case COMMAND_BIND_PROGRAM:
+			{
+				const CommandBindProgram* command = (const CommandBindProgram*)header;
+				GLState::UseProgram(command->program);
+				break;
+			}
+			case COMMAND_BIND_UNIFORM_BUFFER_RANGE:
+			{
+				const CommandBindUniformBufferRange* command = (const CommandBindUniformBufferRange*)header;
+				GLState::BindBufferRange(GL_UNIFORM_BUFFER, command->binding, command->buffer, command->offset, command->size);
+				break;
+			}
+			case COMMAND_BIND_VERTEX_ARRAY:
+			{
+				const CommandBindVertexArray* command = (const CommandBindVertexArray*)header;
+				GLState::BindVertexArray(command->vertexArray); //IBO binding is part of VAO state
+				break;
+			}
+			case COMMAND_BIND_TEXTURE:
+			{
+				const CommandBindTexture* command = (const CommandBindTexture*)header;
+				GLState::BindTexture(command->unit, command->target, command->texture);
+				break;
+			}
+			case COMMAND_SET_UNIFORM_FLOAT:
+			{
+				const CommandSetUniformFloat* command = (const CommandSetUniformFloat*)header;
+				glUniform1f(command->location, command->value);
+				RenderStats::Add(RENDER_STAT_UNIFORM_CALLS);
+				break;
+			}
+			case COMMAND_INSTANCE_DATA:
+			{
+				const CommandInstanceData* command = (const CommandInstanceData*)header;
+				if (instanceBuffer == 0)
+				{
+					glGenBuffers(1, &instanceBuffer); //Created on first use, command buffer can be constructed before OpenGL context exists
+				}
+				GLState::BindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+				glBufferData(GL_ARRAY_BUFFER, sizeof(glm::mat4) * command->instanceCount, command + 1, GL_STREAM_DRAW); //Orphans storage of earlier draws (see CommandBuffer.h)
+				RenderStats::Add(RENDER_STAT_BUFFER_UPLOAD_BYTES, sizeof(glm::mat4) * command->instanceCount);
+				GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+				break;
+			}
+			case COMMAND_DRAW_INDEXED_INSTANCED:
+			{
+				const CommandDrawIndexedInstanced* command = (const CommandDrawIndexedInstanced*)header;
+
+				//GL 3.3 has no base instance, so instead attribute pointers are moved to the first matrix of the batch (state is stored in the VAO)
+				GLState::BindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+				size_t matrixSize = sizeof(GLfloat) * 16;
+				for (int i = 0; i < 4; i++) //mat4 attribute takes 4 locations, one vec4 column each
+				{
+					GLuint location = INSTANCE_TRANSFORM_LOCATION + i;
+					glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, matrixSize, (void*)(matrixSize * command->firstInstance + sizeof(GLfloat) * 4 * i));
+					glEnableVertexAttribArray(location);
+					glVertexAttribDivisor(location, 1); //Advance once per instance instead of once per vertex
+				}
+				GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+
+				glDrawElementsInstanced(GL_TRIANGLES, command->indexCount, GL_UNSIGNED_INT, 0, command->instanceCount);
+				RenderStats::AddDraw((unsigned long long)(command->indexCount / 3) * command->instanceCount);
+				break;
+			}
+			default:
+				printf("ERROR: Unknown command %u in command buffer\n", header->type);
+				break;
+			}
+		}
+	}
+
+	replayTime = std::chrono::duration<float, std::milli>(Clock::now() - replayBegin).count();
+}
+
+CommandBuffer::~CommandBuffer()
+{
+	if (instanceBuffer != 0)
+	{
+		glDeleteBuffers(1, &instanceBuffer);
+		GLState::ForgetBuffer(instanceBuffer);
+		instanceBuffer = 0;
+	}
+}
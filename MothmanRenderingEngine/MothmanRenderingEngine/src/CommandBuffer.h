@@ -0,0 +1,143 @@
+/*
+Command buffer
+
+Compact list of GPU commands recorded without OpenGL context and replayed later by the thread that has it (main thread).
+Recording only writes plain structs into a linear allocator, so a pass can be recorded by a job on any thread while main thread
+renders something else, Execute then walks the list in order and issues the GL calls (through GLState, so redundant binds are still filtered).
+
+Every command starts with CommandHeader (type and size of the whole command including header and payload), sizes are multiples of
+COMMAND_ALIGNMENT so commands follow each other without gaps inside a block of the allocator. Instance data command carries model matrices
+as payload, Execute uploads them into the instance buffer of the command buffer and following draws read instances from it by first instance.
+Buffers rewritten every frame are uploaded with glBufferData, not glBufferSubData: respecifying the whole storage lets the driver orphan the
+old storage that GPU may still read for the previous frame and hand out new memory, instead of waiting for the GPU.
+
+Commands: program bind, uniform buffer range bind (uniform blocks of the pass, for example camera of the pass or shadow tiles),
+vertex array and texture binds, float uniforms (material), instance data and instanced indexed draws.
+Recorded list binds the program and uniform blocks it draws with, so it doesn't depend on state left by the pass function.
+Framebuffer, viewport, depth state and plain (non-block) uniforms of the pass are set by the pass function before Execute.
+
+Usage (one command buffer is recorded by one thread at a time, Execute only on main thread after recording finished):
+	Begin() -> record commands (AllocateScratch for temporary data of the recording) -> End() -> Execute()
+Begin resets both allocators, memory of previous frames is reused. Recording and replay time are measured separately.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+
+#include <GL\glew.h>
+#include <glm\glm.hpp>
+
+#include "CommonValues.h"
+#include "LinearAllocator.h"
+
+enum CommandType
+{
+	COMMAND_BIND_PROGRAM,
+	COMMAND_BIND_UNIFORM_BUFFER_RANGE,
+	COMMAND_BIND_VERTEX_ARRAY,
+	COMMAND_BIND_TEXTURE,
+	COMMAND_SET_UNIFORM_FLOAT,
+	COMMAND_INSTANCE_DATA,
+	COMMAND_DRAW_INDEXED_INSTANCED,
+	COMMAND_TYPE_COUNT
+};
+
+struct CommandHeader
+{
+	uint32_t type; //CommandType
+	uint32_t size; //Bytes of the whole command, next command starts right after it
+};
+
+struct CommandBindProgram
+{
+	CommandHeader header;
+	GLuint program;
+};
+
+struct CommandBindUniformBufferRange
+{
+	CommandHeader header;
+	GLuint binding; //Uniform buffer binding point of the block
+	GLuint buffer;
+	uint32_t offset; //Multiple of GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+	uint32_t size;
+};
+
+struct CommandBindVertexArray
+{
+	CommandHeader header;
+	GLuint vertexArray;
+};
+
+struct CommandBindTexture
+{
+	CommandHeader header;
+	GLuint unit; //Number, not GL_TEXTURE0 + unit
+	GLenum target;
+	GLuint texture;
+};
+
+struct CommandSetUniformFloat
+{
+	CommandHeader header;
+	GLint location; //Of the program used when the buffer is executed
+	GLfloat value;
+};
+
+struct CommandInstanceData //Followed by instanceCount model matrices
+{
+	CommandHeader header;
+	uint32_t instanceCount;
+	uint32_t padding;
+};
+
+struct CommandDrawIndexedInstanced //Triangles with unsigned int indices of bound vertex array
+{
+	CommandHeader header;
+	GLsizei indexCount;
+	GLsizei firstInstance; //Into matrices of the last instance data command
+	GLsizei instanceCount;
+};
+
+class CommandBuffer
+{
+public:
+	CommandBuffer();
+
+	void Begin(); //Clear commands of previous recording
+	void End();
+
+	void BindProgram(GLuint program);
+	void BindUniformBufferRange(GLuint binding, GLuint buffer, GLintptr offset, GLsizeiptr size);
+	void BindVertexArray(GLuint vertexArray);
+	void BindTexture(GLuint unit, GLenum target, GLuint texture);
+	void SetUniform(GLint location, GLfloat value);
+	glm::mat4* InstanceData(uint32_t instanceCount); //Returns matrices to fill, valid until next Begin
+	void DrawIndexedInstanced(GLsizei indexCount, GLsizei firstInstance, GLsizei instanceCount);
+
+	template<typename T> T* AllocateScratch(size_t count) { return scratch.Allocate<T>(count); } //Memory of the recording thread that is not replayed, freed by next Begin
+
+	void Execute(); //Replay on main thread
+
+	unsigned int GetCommandCount() { return commandCount; }
+	size_t GetCommandBytes() { return commands.GetUsedBytes(); }
+	size_t GetReservedBytes() { return commands.GetReservedBytes() + scratch.GetReservedBytes(); }
+	float GetRecordTime() { return recordTime; } //Milliseconds between Begin and End
+	float GetReplayTime() { return replayTime; } //Milliseconds of last Execute
+
+	~CommandBuffer();
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	LinearAllocator commands;
+	LinearAllocator scratch;
+	unsigned int commandCount;
+	Clock::time_point recordBegin;
+	float recordTime, replayTime;
+	GLuint instanceBuffer;
+
+	void* AddCommand(CommandType type, size_t size); //Size of command struct, payload included
+};
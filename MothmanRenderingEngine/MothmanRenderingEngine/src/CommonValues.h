@@ -3,22 +3,76 @@
 
 #include "stb_image.h"
 
-const int MAX_POINT_LIGHTS = 5;
-const int MAX_SPOT_LIGHTS = 5;
+const int MAX_POINT_LIGHTS = 256;
+const int MAX_SPOT_LIGHTS = 256;
+const int MAX_SHADOWED_LIGHTS = 10; //Point and spot lights that can have tiles in the shadow atlas at the same time
 const int TEXTURES_PER_MATERIAL = 2;
+const int MAX_SHADOW_CASCADES = 4; //Layers of directional shadow map array (has to match fragment shader)
+
+const int SHADOW_ATLAS_SIZE = 4096; //Width and height of the depth atlas shared by all point and spot light shadows
+const int MAX_SHADOW_TILE_SIZE = 1024;
+const int MIN_SHADOW_TILE_SIZE = 64;
+const int MAX_SHADOW_TILES = MAX_SHADOWED_LIGHTS * 6; //Size of tile arrays in shadow tiles uniform block (has to match fragment shader)
+const int SHADOW_TILES_UBO_BINDING = 0;
+const int SHADOW_MOMENTS_SCALE = 2; //EVSM moments atlas is this many times smaller than depth atlas (same tile layout in uv)
 
 const int SKYBOX_TEXUNIT = 0;
 const int DIFFUSE_TEXUNIT = 1;
 const int NORMAL_TEXUNIT = 2;
 const int DIR_SHADOWMAP_TEXUNIT = 3;
 const int HEIGHTMAP_TEXUNIT = 4;
-const int OMNIDIR_SHADOWMAP_TEXUNIT = 5; //Range between 4 and omnilights count
+const int SHADOW_ATLAS_TEXUNIT = 5;
+const int SHADOW_MOMENTS_TEXUNIT = 6;
+const int LIGHT_DATA_TEXUNIT = 7;
+const int CLUSTER_GRID_TEXUNIT = 8;
+const int CLUSTER_LIGHT_INDEX_TEXUNIT = 9;
+const int GL_STATE_TEXTURE_UNITS = 16; //Texture units whose bindings are cached by GLState (guaranteed minimum of GL 3.3 fragment shader)
+const int GL_STATE_UNIFORM_BINDINGS = 8; //Uniform buffer binding points whose ranges are cached by GLState
+
+const int CLUSTER_GRID_X = 16; //Screen tiles horizontally
+const int CLUSTER_GRID_Y = 9;
+const int CLUSTER_GRID_Z = 24; //Exponential depth slices
+const int MAX_LIGHTS_PER_CLUSTER = 128;
+const int LIGHT_DATA_TEXELS = 5; //RGBA32F texels per light in light data buffer texture (has to match fragment shader)
+
+const int OCCLUSION_BUFFER_WIDTH = 256; //Software depth buffer of occlusion culler (has to be multiple of tile size)
+const int OCCLUSION_BUFFER_HEIGHT = 128;
+const int OCCLUSION_TILE_WIDTH = 32; //Pixels of one bin, multiple of 4 (SSE rasterizes four pixels at once)
+const int OCCLUSION_TILE_HEIGHT = 16;
+const int OCCLUSION_BIN_JOBS = 4; //Binning jobs, each has its own bins
+const int OCCLUSION_TRIANGLE_BUDGET = 100000; //Occluder triangles rasterized per frame, largest occluders on screen go first
+const int TERRAIN_HEIGHT_GRID = 64; //Cells per side of CPU grid of lowest and highest terrain heights (occluder boxes)
+
+const int JOB_SYSTEM_MAX_WORKERS = 16; //Worker threads of job system (main thread not included)
+const int FRAME_PACKET_COUNT = 3; //Frame packets in the ring, simulation can run at most FRAME_PACKET_COUNT - 1 frames ahead of rendering
+const int FRAME_PIPELINE_DEFAULT_DEPTH = 1; //Frames simulated ahead, 0 simulates and renders the same frame
+const int COMMAND_BUFFER_BLOCK_SIZE = 64 * 1024; //Bytes of one block of command buffer linear allocators, bigger allocations get their own block
 
 const int POSTPROCESSES = 5;
 
+const int RENDER_GRAPH_SIZE_BUCKET = 128; //Render graph textures are rounded up to multiple of this (in pixels)
+const int RENDER_GRAPH_RESIZE_DEBOUNCE = 10; //Frames window size has to stay the same before render graph textures are reallocated
+const int RENDER_GRAPH_POOL_LIFETIME = 120; //Frames after which unused render graph texture is deleted
+
+const int FRAME_TIMER_LATENCY = 4; //Frames between issuing GPU timestamp query and reading its result
+const float FRAME_TIMER_SMOOTHING = 0.1f; //Weight of new sample in smoothed section times
+const int FRAME_TIMER_HISTORY = 300; //Frames kept for profiler flame graph and trace export
+const float QUALITY_GOVERNOR_DEGRADE_THRESHOLD = 1.05f; //Frame time above budget * this counts as over budget
+const float QUALITY_GOVERNOR_UPGRADE_THRESHOLD = 0.8f; //Frame time below budget * this counts as headroom
+const int QUALITY_GOVERNOR_DEGRADE_FRAMES = 30; //Frames in a row over budget before quality is lowered
+const int QUALITY_GOVERNOR_UPGRADE_FRAMES = 180; //Frames in a row with headroom before quality is raised
+const int QUALITY_GOVERNOR_COOLDOWN_FRAMES = 60; //Frames after a change that are not evaluated (timers settle on new cost)
+
+const int INSTANCE_TRANSFORM_LOCATION = 4; //First of four vertex attribute locations (one per column) holding per-instance model matrix
+
+const int HEADLESS_READBACK_BUFFERS = 3; //Pixel buffers in flight in headless mode, frame is mapped this many frames after it was read
+
 const int WINDOW_SIZE_WIDTH_START = 1400;
 const int WINDOW_SIZE_HEIGHT_START = 800;
 
 
-const int SSAO_MAX_SAMPLES_PER_KERNEL = 64;
+const int SSAO_MAX_SAMPLES_PER_KERNEL = 64; //Size of sample array in SSAOKernel uniform block (has to match SSAO shader)
+const int SSAO_KERNEL_UBO_BINDING = 1;
+const int PASS_UNIFORMS_UBO_BINDING = 2; //View and projection of depth and shadow cascade passes (PassUniforms block)
+const int SSAO_NOISE_SIZE = 4; //Width and height of kernel rotation texture (also size of blur in SSAO blur shader)
 #endif
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include "Culling.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#define CULLING_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+Culling::Culling()
+{
+}
+
+void Culling::CullSpheresByPlanes(const glm::vec4* planes, int planeCount, const float* centerX, const float* centerY, const float* centerZ, const float* radius, size_t count, std::vector<uint32_t>& visible)
+{
+	size_t i = 0;
+
+#ifdef CULLING_USE_SSE
+	__m128 zero = _mm_setzero_ps();
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(centerX + i);
+		__m128 y = _mm_loadu_ps(centerY + i);
+		__m128 z = _mm_loadu_ps(centerZ + i);
+		__m128 r = _mm_loadu_ps(radius + i);
+		__m128 inside = _mm_cmpeq_ps(zero, zero); //All bits set - every sphere is inside until one of the planes rejects it
+
+		for (int p = 0; p < planeCount; p++)
+		{
+			__m128 distance = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[p].x), x), _mm_mul_ps(_mm_set1_ps(planes[p].y), y)),
+				_mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[p].z), z), _mm_set1_ps(planes[p].w)));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, r), zero)); //distance >= -radius
+		}
+
+		int mask = _mm_movemask_ps(inside); //One bit per sphere
+		for (int lane = 0; lane < 4; lane++)
+		{
+			if (mask & (1 << lane)) { visible.push_back((uint32_t)(i + lane)); }
+		}
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		bool inside = true;
+		for (int p = 0; p < planeCount && inside; p++)
+		{
+			float distance = planes[p].x * centerX[i] + planes[p].y * centerY[i] + planes[p].z * centerZ[i] + planes[p].w;
+			inside = distance + radius[i] >= 0.0f;
+		}
+		if (inside) { visible.push_back((uint32_t)i); }
+	}
+}
+
+void Culling::CullSpheresBySphere(const glm::vec3& center, float sphereRadius, const float* centerX, const float* centerY, const float* centerZ, const float* radius, size_t count, std::vector<uint32_t>& visible)
+{
+	size_t i = 0;
+
+#ifdef CULLING_USE_SSE
+	__m128 sx = _mm_set1_ps(center.x);
+	__m128 sy = _mm_set1_ps(center.y);
+	__m128 sz = _mm_set1_ps(center.z);
+	__m128 sr = _mm_set1_ps(sphereRadius);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 dx = _mm_sub_ps(_mm_loadu_ps(centerX + i), sx);
+		__m128 dy = _mm_sub_ps(_mm_loadu_ps(centerY + i), sy);
+		__m128 dz = _mm_sub_ps(_mm_loadu_ps(centerZ + i), sz);
+		__m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+		__m128 radiusSum = _mm_add_ps(_mm_loadu_ps(radius + i), sr);
+
+		int mask = _mm_movemask_ps(_mm_cmple_ps(distanceSquared, _mm_mul_ps(radiusSum, radiusSum)));
+		for (int lane = 0; lane < 4; lane++)
+		{
+			if (mask & (1 << lane)) { visible.push_back((uint32_t)(i + lane)); }
+		}
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		glm::vec3 offset = glm::vec3(centerX[i], centerY[i], centerZ[i]) - center;
+		float radiusSum = radius[i] + sphereRadius;
+		if (glm::dot(offset, offset) <= radiusSum * radiusSum) { visible.push_back((uint32_t)i); }
+	}
+}
+
+void Culling::CullBoxesBySphere(const glm::vec3& center, float sphereRadius, const float* minX, const float* minY, const float* minZ, const float* maxX, const float* maxY, const float* maxZ, size_t count, std::vector<uint32_t>& visible)
+{
+	size_t i = 0;
+
+#ifdef CULLING_USE_SSE
+	__m128 zero = _mm_setzero_ps();
+	__m128 sx = _mm_set1_ps(center.x);
+	__m128 sy = _mm_set1_ps(center.y);
+	__m128 sz = _mm_set1_ps(center.z);
+	__m128 radiusSquared = _mm_set1_ps(sphereRadius * sphereRadius);
+	for (; i + 4 <= count; i += 4)
+	{
+		//Distance from sphere center to the box along each axis (0 when center is between min and max)
+		__m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(minX + i), sx), _mm_sub_ps(sx, _mm_loadu_ps(maxX + i))), zero);
+		__m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(minY + i), sy), _mm_sub_ps(sy, _mm_loadu_ps(maxY + i))), zero);
+		__m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(minZ + i), sz), _mm_sub_ps(sz, _mm_loadu_ps(maxZ + i))), zero);
+		__m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+		int mask = _mm_movemask_ps(_mm_cmple_ps(distanceSquared, radiusSquared));
+		for (int lane = 0; lane < 4; lane++)
+		{
+			if (mask & (1 << lane)) { visible.push_back((uint32_t)(i + lane)); }
+		}
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		float dx = glm::max(glm::max(minX[i] - center.x, center.x - maxX[i]), 0.0f);
+		float dy = glm::max(glm::max(minY[i] - center.y, center.y - maxY[i]), 0.0f);
+		float dz = glm::max(glm::max(minZ[i] - center.z, center.z - maxZ[i]), 0.0f);
+		if (dx * dx + dy * dy + dz * dz <= sphereRadius * sphereRadius) { visible.push_back((uint32_t)i); }
+	}
+}
+
+Culling::~Culling()
+{
+}
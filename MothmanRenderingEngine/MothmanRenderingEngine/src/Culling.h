@@ -0,0 +1,32 @@
+/*
+Culling
+
+Bounding spheres are stored as structure of arrays (separate x, y, z and radius arrays) so that kernels can load four spheres with one instruction.
+SSE kernels test four spheres per iteration against every plane, remaining spheres (and builds without SSE) go through scalar path.
+Indices of spheres that passed the test are appended to visible list in increasing order.
+
+Sphere with infinite radius is never culled (used for meshes without bounds).
+Boxes are stored the same way (separate min and max arrays for every axis).
+*/
+
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+#include <glm\glm.hpp>
+
+class Culling
+{
+public:
+	Culling();
+
+	//Keep spheres that are not completely behind any of the planes (plane xyz - normalized normal pointing inside, w - distance)
+	static void CullSpheresByPlanes(const glm::vec4* planes, int planeCount, const float* centerX, const float* centerY, const float* centerZ, const float* radius, size_t count, std::vector<uint32_t>& visible);
+	//Keep spheres that intersect given sphere (used for sphere of influence of point lights)
+	static void CullSpheresBySphere(const glm::vec3& center, float sphereRadius, const float* centerX, const float* centerY, const float* centerZ, const float* radius, size_t count, std::vector<uint32_t>& visible);
+	//Keep axis aligned boxes that intersect given sphere (used for light assignment to clusters)
+	static void CullBoxesBySphere(const glm::vec3& center, float sphereRadius, const float* minX, const float* minY, const float* minZ, const float* maxX, const float* maxY, const float* maxZ, size_t count, std::vector<uint32_t>& visible);
+
+	~Culling();
+};
@@ -0,0 +1,66 @@
+#include "FramePipeline.h"
+
+FramePipeline::FramePipeline()
+{
+	depth = FRAME_PIPELINE_DEFAULT_DEPTH;
+	simulatedCount = 0;
+	renderedCount = 0;
+	renderPacket = nullptr;
+}
+
+void FramePipeline::SetDepth(int depth)
+{
+	this->depth = glm::clamp(depth, 0, FRAME_PACKET_COUNT - 1);
+}
+
+FramePacket* FramePipeline::BeginSimulation()
+{
+	FramePacket* packet = &packets[simulatedCount % FRAME_PACKET_COUNT];
+	if (packet == renderPacket)
+	{
+		renderPacket = nullptr; //Rendered already, next acquire takes a new packet
+	}
+	packet->frame = simulatedCount;
+	simulatedCount++;
+	return packet;
+}
+
+FramePacket* FramePipeline::GetPreviousPacket()
+{
+	if (simulatedCount < 2)
+	{
+		return nullptr;
+	}
+	return &packets[(simulatedCount - 2) % FRAME_PACKET_COUNT];
+}
+
+FramePacket* FramePipeline::AcquireRenderPacket(bool flush)
+{
+	int framesInFlight = GetFramesInFlight();
+	if (framesInFlight > depth || (framesInFlight > 0 && (flush || renderPacket == nullptr)))
+	{
+		renderPacket = &packets[renderedCount % FRAME_PACKET_COUNT];
+		WaitForJobs(renderPacket);
+		renderedCount++;
+	}
+	return renderPacket;
+}
+
+void FramePipeline::Flush()
+{
+	for (int i = renderedCount; i < simulatedCount; i++)
+	{
+		WaitForJobs(&packets[i % FRAME_PACKET_COUNT]);
+	}
+}
+
+void FramePipeline::WaitForJobs(FramePacket* packet)
+{
+	JobSystem::Wait(&packet->animation);
+	JobSystem::Wait(&packet->scene);
+	JobSystem::Wait(&packet->occlusion);
+}
+
+FramePipeline::~FramePipeline()
+{
+}
@@ -0,0 +1,98 @@
+/*
+Frame pipeline
+
+Simulation of frame N + 1 (animation, scene submission, camera frustum and occlusion culling) runs as a chain of jobs while main thread
+(the only thread with OpenGL context) renders frame N. Everything the render thread needs from simulation is in a frame packet:
+copy of the camera, render queue with transforms, camera visible list, moved lights and stats. Packet is written only by its simulation jobs
+and is read only once it is acquired for rendering, so the two frames never share mutable data.
+
+Packets live in a ring of FRAME_PACKET_COUNT (triple buffering): one is being rendered, up to two are being simulated or wait for rendering.
+Depth is how many frames simulation runs ahead of rendering:
+- 0 (latency): packet is simulated and rendered in the same loop iteration, main thread waits for (and helps with) its jobs,
+  input reaches the screen in one frame
+- 1 (throughput, default): simulation of next frame overlaps rendering of current one, input shows one frame later
+- 2: more slack for frames with uneven simulation cost, two frames of latency
+When nothing new is due (start of the pipeline, depth just raised) the last packet is rendered again. Lowering depth doesn't drop packets,
+simulation waits until frames in flight are rendered (shadow caching compares every packet with the previous one, none may be skipped).
+
+Rules:
+- Main thread fills inputs of the packet right after BeginSimulation (camera, delta time, settings), then schedules its jobs. Jobs fill outputs.
+  Jobs of one packet run in order animation -> scene -> occlusion, animation of next packet waits for occlusion of previous one,
+  so simulation state outside of packets (animation angles, occlusion culler) has one writer at a time.
+- Simulation jobs may read render queue of previous packet (shadow caster changes). Its slot can be handed out again while they run,
+  but main thread writes only inputs and jobs of the new packet start after them.
+- Render thread waits for all jobs of a packet in AcquireRenderPacket, Flush waits for all packets in flight (before restarting job system).
+*/
+
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+#include <glm\glm.hpp>
+
+#include "CommonValues.h"
+#include "Camera.h"
+#include "RenderQueue.h"
+#include "OcclusionCuller.h"
+#include "JobSystem.h"
+
+struct FramePacketLight //Light moved by simulation, render thread applies the position before the frame
+{
+	unsigned int index; //Point light index
+	glm::vec3 position;
+};
+
+struct FramePacket
+{
+	int frame; //Sequence number of simulated frames, from 0
+	float deltaTime;
+	Camera camera; //Copy of player camera with view matrix and frustum calculated
+
+	//Settings read by simulation, copied by main thread with the camera
+	bool showTerrain;
+	bool showTeapots;
+	bool occlusionCulling;
+	float orbitingLightSpeed;
+	float orbitingLightRadius;
+	float sculptureRotationSpeed;
+
+	//Results of simulation
+	RenderQueue renderQueue; //Read only during rendering: shadow passes cull it, passes are recorded from it by render jobs
+	std::vector<uint32_t> cameraVisiblePackets; //After frustum and occlusion culling, shared by depth and main pass
+	CullScratch cameraCullScratch;
+	std::vector<FramePacketLight> lights;
+	OcclusionStats occlusionStats;
+
+	JobCounter animation, scene, occlusion; //Simulation jobs of the packet
+};
+
+class FramePipeline
+{
+public:
+	FramePipeline();
+
+	void SetDepth(int depth); //Clamped to 0..FRAME_PACKET_COUNT - 1
+	int GetDepth() { return depth; }
+
+	bool CanBeginSimulation() { return GetFramesInFlight() <= depth; }
+	FramePacket* BeginSimulation(); //Next packet to fill, only when CanBeginSimulation
+	FramePacket* GetPreviousPacket(); //Packet simulated before the one from last BeginSimulation, nullptr for the first one
+	FramePacket* AcquireRenderPacket(bool flush); //Waits for jobs of the oldest packet when it is due (or always with flush), otherwise returns last packet again
+	void Flush(); //Wait for jobs of all packets in flight, they are still rendered later
+
+	int GetFramesInFlight() { return simulatedCount - renderedCount; } //Simulated or being simulated, not acquired yet
+	int GetSimulatedCount() { return simulatedCount; }
+	int GetRenderedCount() { return renderedCount; }
+
+	~FramePipeline();
+
+private:
+	FramePacket packets[FRAME_PACKET_COUNT];
+	int depth;
+	int simulatedCount; //Packets handed out by BeginSimulation
+	int renderedCount; //Packets acquired for rendering
+	FramePacket* renderPacket; //Acquired last, nullptr before the first one and after its slot was handed out again
+
+	void WaitForJobs(FramePacket* packet);
+};
@@ -0,0 +1,308 @@
+#include "FrameTimer.h"
+
+FrameTimer::FrameTimer()
+{
+	frame = 0;
+	historyPaused = false;
+	creationTime = Clock::now();
+	frameBegin = creationTime;
+	for (int i = 0; i < FRAME_TIMER_LATENCY; i++)
+	{
+		slots[i].issued = false;
+	}
+	GetSection("Frame");
+}
+
+void FrameTimer::BeginFrame()
+{
+	frame++;
+	Slot& slot = slots[GetSlot()];
+	CollectSlot(slot); //Written FRAME_TIMER_LATENCY frames ago, GPU should be done with it
+
+	frameBegin = Clock::now();
+	slot.record.frame = frame;
+	slot.record.cpuStart = std::chrono::duration<double, std::milli>(frameBegin - creationTime).count();
+	slot.record.gpuValid = false;
+	slot.record.events.clear();
+	slot.record.jobs.clear();
+
+	openEvents.clear();
+	openEventStats.clear();
+	RenderStats::Reset();
+	BeginEvent(0);
+}
+
+void FrameTimer::EndFrame()
+{
+	while (openEvents.size() > 1) //Section left open would never be closed
+	{
+		EndEvent();
+	}
+	EndEvent();
+
+	Slot& slot = slots[GetSlot()];
+	slot.issued = true;
+
+	std::vector<float> cpuTimes(sections.size(), -1.0f); //Sum of events of every section timed in this frame
+	for (size_t i = 0; i < slot.record.events.size(); i++)
+	{
+		const FrameTimerEvent& event = slot.record.events[i];
+		Section& section = sections[event.section];
+		if (cpuTimes[event.section] < 0.0f)
+		{
+			section.stats = RenderStatValues(); //First event of the section in this frame
+		}
+		for (int stat = 0; stat < RENDER_STAT_COUNT; stat++) { section.stats.values[stat] += event.stats.values[stat]; }
+		cpuTimes[event.section] = glm::max(cpuTimes[event.section], 0.0f) + event.cpuEnd - event.cpuBegin;
+	}
+	for (size_t i = 0; i < slot.record.jobs.size(); i++)
+	{
+		const FrameTimerJob& job = slot.record.jobs[i];
+		cpuTimes[job.section] = glm::max(cpuTimes[job.section], 0.0f) + job.cpuEnd - job.cpuBegin;
+	}
+	for (size_t i = 0; i < sections.size(); i++)
+	{
+		if (cpuTimes[i] < 0.0f)
+		{
+			continue;
+		}
+		sections[i].cpuTime = Smooth(sections[i].cpuTime, cpuTimes[i]);
+		sections[i].cpuSample = cpuTimes[i];
+		sections[i].cpuSampleFrame = frame;
+	}
+}
+
+void FrameTimer::Begin(const std::string& name)
+{
+	BeginEvent(GetSection(name));
+}
+
+void FrameTimer::End()
+{
+	if (openEvents.size() <= 1) //Only the frame is open
+	{
+		printf("ERROR: Frame timer section ended without being begun\n");
+		return;
+	}
+	EndEvent();
+}
+
+void FrameTimer::AddJob(const char* name, unsigned int thread, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+{
+	FrameTimerJob job;
+	job.section = GetSection(name);
+	job.thread = thread;
+	job.cpuBegin = std::chrono::duration<float, std::milli>(begin - frameBegin).count();
+	job.cpuEnd = std::chrono::duration<float, std::milli>(end - frameBegin).count();
+	sections[job.section].job = true;
+	slots[GetSlot()].record.jobs.push_back(job);
+}
+
+float FrameTimer::GetCPUTime(const std::string& name)
+{
+	std::unordered_map<std::string, int>::iterator found = sectionIndices.find(name);
+	return found == sectionIndices.end() ? 0.0f : sections[found->second].cpuTime;
+}
+
+float FrameTimer::GetGPUTime(const std::string& name)
+{
+	std::unordered_map<std::string, int>::iterator found = sectionIndices.find(name);
+	return found == sectionIndices.end() ? 0.0f : sections[found->second].gpuTime;
+}
+
+bool FrameTimer::GetSectionCPUSample(int section, float& time)
+{
+	time = sections[section].cpuSample;
+	return sections[section].cpuSampleFrame == frame;
+}
+
+bool FrameTimer::GetSectionGPUSample(int section, float& time)
+{
+	time = sections[section].gpuSample;
+	return sections[section].gpuSampleFrame == frame;
+}
+
+bool FrameTimer::WriteChromeTrace(const std::string& fileLocation, int firstIndex, int count)
+{
+	FILE* file = fopen(fileLocation.c_str(), "w");
+	if (file == nullptr)
+	{
+		printf("ERROR: Could not open %s for writing\n", fileLocation.c_str());
+		return false;
+	}
+
+	//Complete events ("X") in microseconds, CPU and GPU as two threads of one process. GPU events are placed at CPU start of their frame
+	//(GPU clock isn't related to CPU clock), so GPU lane shows how long GPU worked on the frame, not when.
+	//Jobs are threads 3 and up, one per job system thread (3 is main thread)
+	int lastIndex = glm::min(firstIndex + count, (int)history.size());
+	unsigned int jobThreads = 0;
+	for (int f = glm::max(firstIndex, 0); f < lastIndex; f++)
+	{
+		for (size_t i = 0; i < history[f].jobs.size(); i++) { jobThreads = glm::max(jobThreads, history[f].jobs[i].thread + 1); }
+	}
+
+	fprintf(file, "{\"traceEvents\":[\n");
+	fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n");
+	fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}");
+	for (unsigned int thread = 0; thread < jobThreads; thread++)
+	{
+		if (thread == 0) { fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":3,\"args\":{\"name\":\"Jobs (main thread)\"}}"); }
+		else { fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"Jobs (worker %u)\"}}", thread + 3, thread); }
+	}
+	for (int f = glm::max(firstIndex, 0); f < lastIndex; f++)
+	{
+		const FrameTimerRecord& record = history[f];
+		for (size_t i = 0; i < record.events.size(); i++)
+		{
+			const FrameTimerEvent& event = record.events[i];
+			const char* name = sections[event.section].name.c_str();
+			fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"CPU\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u}}",
+				name, (record.cpuStart + event.cpuBegin) * 1000.0, (event.cpuEnd - event.cpuBegin) * 1000.0, record.frame);
+			if (record.gpuValid)
+			{
+				fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"GPU\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u}}",
+					name, (record.cpuStart + event.gpuBegin) * 1000.0, (event.gpuEnd - event.gpuBegin) * 1000.0, record.frame);
+			}
+		}
+		for (size_t i = 0; i < record.jobs.size(); i++)
+		{
+			const FrameTimerJob& job = record.jobs[i];
+			fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"Job\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u}}",
+				sections[job.section].name.c_str(), job.thread + 3, (record.cpuStart + job.cpuBegin) * 1000.0, (job.cpuEnd - job.cpuBegin) * 1000.0, record.frame);
+		}
+	}
+	fprintf(file, "\n]}\n");
+	fclose(file);
+
+	printf("LOG: Chrome trace of %d frames written to %s\n", glm::max(lastIndex - firstIndex, 0), fileLocation.c_str());
+	return true;
+}
+
+int FrameTimer::GetSection(const std::string& name)
+{
+	std::unordered_map<std::string, int>::iterator found = sectionIndices.find(name);
+	if (found != sectionIndices.end())
+	{
+		return found->second;
+	}
+
+	Section section;
+	section.name = name;
+	section.cpuTime = 0.0f;
+	section.gpuTime = 0.0f;
+	section.cpuSample = 0.0f;
+	section.gpuSample = 0.0f;
+	section.cpuSampleFrame = 0;
+	section.gpuSampleFrame = 0;
+	section.stats = RenderStatValues();
+	section.job = false;
+	sectionIndices[name] = (int)sections.size();
+	sections.push_back(section);
+	return (int)sections.size() - 1;
+}
+
+void FrameTimer::BeginEvent(int section)
+{
+	Slot& slot = slots[GetSlot()];
+	size_t index = slot.record.events.size();
+	if (slot.queries.size() < (index + 1) * 2) //Queries are created on first use, timer can exist before OpenGL context
+	{
+		slot.queries.resize((index + 1) * 2);
+		glGenQueries(2, &slot.queries[index * 2]);
+	}
+
+	FrameTimerEvent event;
+	event.section = section;
+	event.depth = (int)openEvents.size();
+	event.cpuBegin = GetCPUTimeInFrame();
+	event.cpuEnd = event.cpuBegin;
+	event.gpuBegin = -1.0f;
+	event.gpuEnd = -1.0f;
+	event.stats = RenderStatValues();
+	slot.record.events.push_back(event);
+	openEvents.push_back((int)index);
+	openEventStats.push_back(RenderStats::GetTotals());
+
+	glQueryCounter(slot.queries[index * 2], GL_TIMESTAMP);
+}
+
+void FrameTimer::EndEvent()
+{
+	Slot& slot = slots[GetSlot()];
+	int index = openEvents.back();
+	openEvents.pop_back();
+
+	glQueryCounter(slot.queries[index * 2 + 1], GL_TIMESTAMP);
+	FrameTimerEvent& event = slot.record.events[index];
+	event.cpuEnd = GetCPUTimeInFrame();
+	const RenderStatValues& totals = RenderStats::GetTotals();
+	for (int stat = 0; stat < RENDER_STAT_COUNT; stat++) { event.stats.values[stat] = totals.values[stat] - openEventStats.back().values[stat]; }
+	openEventStats.pop_back();
+}
+
+void FrameTimer::CollectSlot(Slot& slot)
+{
+	if (!slot.issued)
+	{
+		return;
+	}
+	slot.issued = false;
+
+	GLint available = 0;
+	glGetQueryObjectiv(slot.queries[1], GL_QUERY_RESULT_AVAILABLE, &available); //Frame ends after all its events
+	if (available)
+	{
+		GLuint64 frameStart = 0;
+		glGetQueryObjectui64v(slot.queries[0], GL_QUERY_RESULT, &frameStart);
+
+		std::vector<float> gpuTimes(sections.size(), -1.0f);
+		for (size_t i = 0; i < slot.record.events.size(); i++)
+		{
+			FrameTimerEvent& event = slot.record.events[i];
+			GLuint64 begin = 0, end = 0;
+			glGetQueryObjectui64v(slot.queries[i * 2], GL_QUERY_RESULT, &begin);
+			glGetQueryObjectui64v(slot.queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+			event.gpuBegin = (float)(begin - frameStart) / 1000000.0f; //Nanoseconds to milliseconds
+			event.gpuEnd = (float)(end - frameStart) / 1000000.0f;
+			gpuTimes[event.section] = glm::max(gpuTimes[event.section], 0.0f) + event.gpuEnd - event.gpuBegin;
+		}
+
+		for (size_t i = 0; i < sections.size(); i++)
+		{
+			if (gpuTimes[i] < 0.0f)
+			{
+				continue;
+			}
+			sections[i].gpuSample = gpuTimes[i];
+			sections[i].gpuSampleFrame = frame;
+			sections[i].gpuTime = Smooth(sections[i].gpuTime, gpuTimes[i]);
+		}
+		slot.record.gpuValid = true;
+	}
+
+	if (!historyPaused)
+	{
+		history.push_back(slot.record);
+		if (history.size() > (size_t)FRAME_TIMER_HISTORY)
+		{
+			history.pop_front();
+		}
+	}
+}
+
+void FrameTimer::ReleaseQueries()
+{
+	for (int i = 0; i < FRAME_TIMER_LATENCY; i++)
+	{
+		if (!slots[i].queries.empty())
+		{
+			glDeleteQueries((GLsizei)slots[i].queries.size(), &slots[i].queries[0]);
+		}
+		slots[i].queries.clear();
+		slots[i].issued = false;
+	}
+}
+
+FrameTimer::~FrameTimer()
+{
+}
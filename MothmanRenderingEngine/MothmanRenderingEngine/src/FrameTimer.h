@@ -0,0 +1,165 @@
+/*
+Frame timer (hierarchical CPU/GPU profiler)
+
+Measures CPU and GPU time of named sections of the frame (render graph passes, shadow passes, profiling scopes) and of the whole frame.
+Sections can be nested and timed several times per frame, every Begin/End pair is recorded as an event with its depth.
+- CPU: std::chrono::steady_clock between Begin and End.
+- GPU: GL_TIMESTAMP queries at Begin and End (timestamps, unlike GL_TIME_ELAPSED, can be nested). Reading a result of the frame
+  that was just submitted would stall until GPU finishes it, so every frame of the ring of FRAME_TIMER_LATENCY frames has its own queries
+  and results are read when the slot comes around again. Frame whose results still aren't available loses its GPU times instead of waiting.
+Section times are per frame (sum of all its events), smoothed exponentially (FRAME_TIMER_SMOOTHING), so one slow frame doesn't look like a trend.
+Sections skipped in a frame keep their last value.
+Raw samples (not smoothed) are kept for benchmarks: CPU sample of the section timed in current frame and GPU sample collected
+in current BeginFrame (that one belongs to frame FRAME_TIMER_LATENCY frames old).
+
+History: frames with collected GPU times are kept for FRAME_TIMER_HISTORY frames (flame graph, Chrome trace export).
+Event times are relative to the start of their frame (CPU) and to the first GPU timestamp of the frame (GPU).
+
+Render stats: counters (RenderStats) are reset at BeginFrame, every event stores how much they grew between its Begin and End,
+section stats are sums of its events in the frame (like times).
+
+Jobs: JobSystem timings of the frame are added with AddJob (main thread, before EndFrame). Every job name is a section of its own
+(names have to differ from names of Begin/End sections), its CPU time is the sum of all its runs on all threads, so it can be bigger than
+the time it took on the timeline. Jobs are kept in the history record apart from events, with thread they ran on (profiler job lanes,
+Chrome trace thread per job system thread). Job sections have no GPU time and no render stats.
+
+Profiling scopes (PROFILE_SCOPE) are compiled only in debug builds or with MOTHMAN_PROFILING defined, name expression isn't evaluated otherwise.
+Timing the governor depends on (render graph passes, shadows, terrain) uses Begin/End directly and is always on.
+*/
+
+#pragma once
+
+#include <stdio.h>
+#include <vector>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <chrono>
+
+#include <GL\glew.h>
+
+#include <glm\glm.hpp>
+
+#include "CommonValues.h"
+#include "RenderStats.h"
+
+struct FrameTimerEvent
+{
+	int section;
+	int depth; //0 is the frame itself
+	float cpuBegin, cpuEnd; //Milliseconds from frame start
+	float gpuBegin, gpuEnd; //Milliseconds from first GPU timestamp of the frame, negative when not available
+	RenderStatValues stats; //Render stats counted inside the event (nested events included)
+};
+
+struct FrameTimerJob
+{
+	int section;
+	unsigned int thread; //Job system thread, 0 is main thread
+	float cpuBegin, cpuEnd; //Milliseconds from frame start
+};
+
+struct FrameTimerRecord
+{
+	unsigned int frame;
+	double cpuStart; //Milliseconds since timer creation
+	bool gpuValid;
+	std::vector<FrameTimerEvent> events; //In begin order, first event is the whole frame
+	std::vector<FrameTimerJob> jobs; //In order they were added
+};
+
+class FrameTimer
+{
+public:
+	FrameTimer();
+
+	void BeginFrame(); //Collect GPU results of old frames and start timing the frame
+	void EndFrame(); //Before swapping buffers, so waiting for vsync isn't counted
+
+	void Begin(const std::string& name);
+	void End(); //Ends the section begun last
+	void AddJob(const char* name, unsigned int thread, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end); //Job run in current frame
+
+	float GetCPUTime(const std::string& name); //Milliseconds, 0 for unknown section
+	float GetGPUTime(const std::string& name);
+	float GetFrameCPUTime() { return sections[0].cpuTime; }
+	float GetFrameGPUTime() { return sections[0].gpuTime; }
+
+	unsigned int GetSectionCount() { return (unsigned int)sections.size(); } //Section 0 is the frame
+	const std::string& GetSectionName(int section) { return sections[section].name; }
+	float GetSectionCPUTime(int section) { return sections[section].cpuTime; }
+	float GetSectionGPUTime(int section) { return sections[section].gpuTime; }
+	bool IsJobSection(int section) { return sections[section].job; }
+	bool GetSectionCPUSample(int section, float& time); //False when section wasn't timed in current frame
+	bool GetSectionGPUSample(int section, float& time); //False when no result was collected in current frame
+	float GetFrameCPUSample() { return sections[0].cpuSample; } //Last finished frame
+	unsigned long long GetSectionStat(int section, RenderStat stat) { return sections[section].stats.values[stat]; } //Last frame the section was timed in
+	unsigned long long GetFrameStat(RenderStat stat) { return sections[0].stats.values[stat]; }
+
+	unsigned int GetHistoryCount() { return (unsigned int)history.size(); }
+	const FrameTimerRecord& GetHistoryFrame(int index) { return history[index]; } //0 is the oldest
+	bool IsHistoryPaused() { return historyPaused; }
+	void SetHistoryPaused(bool value) { historyPaused = value; } //Keep history as it is for inspection
+	bool WriteChromeTrace(const std::string& fileLocation, int firstIndex, int count); //History frames as chrome://tracing JSON
+
+	void ReleaseQueries();
+
+	~FrameTimer();
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	struct Section
+	{
+		std::string name;
+		float cpuTime, gpuTime; //Smoothed, in milliseconds
+		float cpuSample, gpuSample; //Latest raw values
+		unsigned int cpuSampleFrame, gpuSampleFrame; //Frame in which the sample was taken or collected
+		RenderStatValues stats;
+		bool job; //Timed by AddJob
+	};
+
+	struct Slot //Frame in flight
+	{
+		FrameTimerRecord record;
+		std::vector<GLuint> queries; //Begin and end timestamp of every event, reused by later frames
+		bool issued;
+	};
+
+	std::vector<Section> sections;
+	std::unordered_map<std::string, int> sectionIndices;
+	Slot slots[FRAME_TIMER_LATENCY];
+	std::vector<int> openEvents; //Stack of events begun and not ended yet
+	std::vector<RenderStatValues> openEventStats; //Render stats at Begin of open events
+	std::deque<FrameTimerRecord> history;
+	bool historyPaused;
+	Clock::time_point creationTime, frameBegin;
+	unsigned int frame;
+
+	int GetSection(const std::string& name);
+	void BeginEvent(int section);
+	void EndEvent();
+	void CollectSlot(Slot& slot);
+	float GetCPUTimeInFrame() { return std::chrono::duration<float, std::milli>(Clock::now() - frameBegin).count(); }
+	int GetSlot() { return frame % FRAME_TIMER_LATENCY; }
+
+	static float Smooth(float value, float sample) { return value == 0.0f ? sample : value + (sample - value) * FRAME_TIMER_SMOOTHING; }
+};
+
+class FrameTimerScope //Times its own lifetime
+{
+public:
+	FrameTimerScope(FrameTimer& timer, const std::string& name) : timer(timer) { timer.Begin(name); }
+	~FrameTimerScope() { timer.End(); }
+
+private:
+	FrameTimer& timer;
+};
+
+#if !defined(NDEBUG) || defined(MOTHMAN_PROFILING)
+#define PROFILE_SCOPE_CONCAT_INNER(a, b) a##b
+#define PROFILE_SCOPE_CONCAT(a, b) PROFILE_SCOPE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(timer, name) FrameTimerScope PROFILE_SCOPE_CONCAT(profileScope, __LINE__)(timer, name)
+#else
+#define PROFILE_SCOPE(timer, name)
+#endif
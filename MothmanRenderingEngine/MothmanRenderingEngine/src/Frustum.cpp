@@ -0,0 +1,43 @@
+#include "Frustum.h"
+
+Frustum::Frustum()
+{
+	for (int i = 0; i < 6; i++)
+	{
+		planes[i] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f); //Everything is inside until planes are extracted
+	}
+}
+
+void Frustum::ExtractPlanes(const glm::mat4& viewProjection)
+{
+	//Gribb-Hartmann method, planes are sums and differences of matrix rows (glm is column major so row i is m[0][i], m[1][i], m[2][i], m[3][i])
+	glm::vec4 rowX = glm::vec4(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+	glm::vec4 rowY = glm::vec4(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+	glm::vec4 rowZ = glm::vec4(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+	glm::vec4 rowW = glm::vec4(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+	planes[0] = rowW + rowX; //Left
+	planes[1] = rowW - rowX; //Right
+	planes[2] = rowW + rowY; //Bottom
+	planes[3] = rowW - rowY; //Top
+	planes[4] = rowW + rowZ; //Near
+	planes[5] = rowW - rowZ; //Far
+
+	for (int i = 0; i < 6; i++)
+	{
+		planes[i] /= glm::length(glm::vec3(planes[i])); //Normalized so that plane equation gives real distance (needed for sphere tests)
+	}
+}
+
+bool Frustum::IntersectsSphere(const glm::vec3& center, float radius) const
+{
+	for (int i = 0; i < 6; i++)
+	{
+		if (glm::dot(glm::vec3(planes[i]), center) + planes[i].w < -radius) { return false; } //Completely behind one of the planes
+	}
+	return true;
+}
+
+Frustum::~Frustum()
+{
+}
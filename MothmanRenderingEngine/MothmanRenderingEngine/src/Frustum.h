@@ -0,0 +1,19 @@
+#pragma once
+
+#include <glm\glm.hpp>
+
+class Frustum
+{
+public:
+	Frustum();
+
+	void ExtractPlanes(const glm::mat4& viewProjection); //Get six planes from combined projection * view matrix (works for perspective and orthographic projections)
+
+	const glm::vec4* GetPlanes() const { return planes; }
+	bool IntersectsSphere(const glm::vec3& center, float radius) const;
+
+	~Frustum();
+
+private:
+	glm::vec4 planes[6]; //Left, right, bottom, top, near, far. xyz - normal pointing inside, w - distance
+};
@@ -0,0 +1,300 @@
+#include "GLState.h"
+
+GLuint GLState::program = GLState::UNKNOWN;
+GLuint GLState::vertexArray = GLState::UNKNOWN;
+GLuint GLState::drawFramebuffer = GLState::UNKNOWN;
+GLuint GLState::readFramebuffer = GLState::UNKNOWN;
+GLuint GLState::activeUnit = GLState::UNKNOWN;
+GLuint GLState::buffers[BUFFER_TARGET_COUNT];
+GLState::BufferRange GLState::uniformRanges[GL_STATE_UNIFORM_BINDINGS];
+GLuint GLState::textures[GL_STATE_TEXTURE_UNITS][TEXTURE_TARGET_COUNT];
+GLint GLState::viewport[4];
+GLint GLState::scissor[4];
+GLuint GLState::capabilities[CAPABILITY_COUNT];
+GLuint GLState::depthMask = GLState::UNKNOWN;
+GLuint GLState::cullFace = GLState::UNKNOWN;
+
+void GLState::Invalidate()
+{
+	program = UNKNOWN;
+	vertexArray = UNKNOWN;
+	drawFramebuffer = UNKNOWN;
+	readFramebuffer = UNKNOWN;
+	activeUnit = UNKNOWN;
+	for (int i = 0; i < BUFFER_TARGET_COUNT; i++) { buffers[i] = UNKNOWN; }
+	for (int i = 0; i < GL_STATE_UNIFORM_BINDINGS; i++) { uniformRanges[i].buffer = UNKNOWN; }
+	for (int unit = 0; unit < GL_STATE_TEXTURE_UNITS; unit++)
+	{
+		for (int i = 0; i < TEXTURE_TARGET_COUNT; i++) { textures[unit][i] = UNKNOWN; }
+	}
+	for (int i = 0; i < 4; i++)
+	{
+		viewport[i] = -1; //Width and height can't be negative
+		scissor[i] = -1;
+	}
+	for (int i = 0; i < CAPABILITY_COUNT; i++) { capabilities[i] = UNKNOWN; }
+	depthMask = UNKNOWN;
+	cullFace = UNKNOWN;
+}
+
+void GLState::UseProgram(GLuint program)
+{
+	if (Change(GLState::program, program, RENDER_STAT_PROGRAM_BINDS))
+	{
+		glUseProgram(program);
+	}
+}
+
+void GLState::BindVertexArray(GLuint vertexArray)
+{
+	if (Change(GLState::vertexArray, vertexArray, RENDER_STAT_VAO_BINDS))
+	{
+		glBindVertexArray(vertexArray);
+	}
+}
+
+void GLState::BindBuffer(GLenum target, GLuint buffer)
+{
+	int index = GetBufferTarget(target);
+	if (index < 0) //Element array buffer (part of VAO) and targets engine doesn't use
+	{
+		RenderStats::Add(RENDER_STAT_STATE_CHANGES);
+		glBindBuffer(target, buffer);
+		return;
+	}
+	if (Change(buffers[index], buffer, RENDER_STAT_STATE_CHANGES))
+	{
+		glBindBuffer(target, buffer);
+	}
+}
+
+void GLState::BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+	bool cached = target == GL_UNIFORM_BUFFER && index < (GLuint)GL_STATE_UNIFORM_BINDINGS;
+	if (cached)
+	{
+		BufferRange& range = uniformRanges[index];
+		if (range.buffer == buffer && range.offset == offset && range.size == size)
+		{
+			RenderStats::Add(RENDER_STAT_REDUNDANT_STATE);
+			return;
+		}
+		range.buffer = buffer;
+		range.offset = offset;
+		range.size = size;
+	}
+	RenderStats::Add(RENDER_STAT_STATE_CHANGES);
+	glBindBufferRange(target, index, buffer, offset, size);
+
+	int bufferTarget = GetBufferTarget(target);
+	if (bufferTarget >= 0) { buffers[bufferTarget] = buffer; } //Generic binding point changed too
+}
+
+void GLState::BindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+	int index = GetTextureTarget(target);
+	if (unit >= (GLuint)GL_STATE_TEXTURE_UNITS || index < 0)
+	{
+		ActiveTexture(unit);
+		RenderStats::Add(RENDER_STAT_TEXTURE_BINDS);
+		glBindTexture(target, texture);
+		return;
+	}
+	if (textures[unit][index] == texture)
+	{
+		RenderStats::Add(RENDER_STAT_REDUNDANT_STATE);
+		return;
+	}
+	ActiveTexture(unit);
+	BindTexture(target, texture);
+}
+
+void GLState::BindTexture(GLenum target, GLuint texture)
+{
+	int index = GetTextureTarget(target);
+	if (activeUnit >= (GLuint)GL_STATE_TEXTURE_UNITS || index < 0) //Unknown active unit has UNKNOWN value too
+	{
+		RenderStats::Add(RENDER_STAT_TEXTURE_BINDS);
+		glBindTexture(target, texture);
+		return;
+	}
+	if (Change(textures[activeUnit][index], texture, RENDER_STAT_TEXTURE_BINDS))
+	{
+		glBindTexture(target, texture);
+	}
+}
+
+void GLState::ActiveTexture(GLuint unit)
+{
+	if (Change(activeUnit, unit, RENDER_STAT_STATE_CHANGES))
+	{
+		glActiveTexture(GL_TEXTURE0 + unit);
+	}
+}
+
+void GLState::BindFramebuffer(GLenum target, GLuint framebuffer)
+{
+	if (target == GL_FRAMEBUFFER)
+	{
+		if (drawFramebuffer == framebuffer && readFramebuffer == framebuffer)
+		{
+			RenderStats::Add(RENDER_STAT_REDUNDANT_STATE);
+			return;
+		}
+		drawFramebuffer = framebuffer;
+		readFramebuffer = framebuffer;
+		RenderStats::Add(RENDER_STAT_FRAMEBUFFER_BINDS);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	}
+	else if (Change(target == GL_READ_FRAMEBUFFER ? readFramebuffer : drawFramebuffer, framebuffer, RENDER_STAT_FRAMEBUFFER_BINDS))
+	{
+		glBindFramebuffer(target, framebuffer);
+	}
+}
+
+void GLState::Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	if (viewport[0] == x && viewport[1] == y && viewport[2] == width && viewport[3] == height)
+	{
+		RenderStats::Add(RENDER_STAT_REDUNDANT_STATE);
+		return;
+	}
+	viewport[0] = x;
+	viewport[1] = y;
+	viewport[2] = width;
+	viewport[3] = height;
+	RenderStats::Add(RENDER_STAT_STATE_CHANGES);
+	glViewport(x, y, width, height);
+}
+
+void GLState::Scissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	if (scissor[0] == x && scissor[1] == y && scissor[2] == width && scissor[3] == height)
+	{
+		RenderStats::Add(RENDER_STAT_REDUNDANT_STATE);
+		return;
+	}
+	scissor[0] = x;
+	scissor[1] = y;
+	scissor[2] = width;
+	scissor[3] = height;
+	RenderStats::Add(RENDER_STAT_STATE_CHANGES);
+	glScissor(x, y, width, height);
+}
+
+void GLState::SetEnabled(GLenum capability, bool enabled)
+{
+	int index = GetCapability(capability);
+	if (index >= 0 && !Change(capabilities[index], enabled ? 1 : 0, RENDER_STAT_STATE_CHANGES))
+	{
+		return;
+	}
+	if (index < 0) { RenderStats::Add(RENDER_STAT_STATE_CHANGES); }
+
+	if (enabled) { glEnable(capability); }
+	else { glDisable(capability); }
+}
+
+void GLState::DepthMask(GLboolean enabled)
+{
+	if (Change(depthMask, enabled ? 1 : 0, RENDER_STAT_STATE_CHANGES))
+	{
+		glDepthMask(enabled);
+	}
+}
+
+void GLState::CullFace(GLenum mode)
+{
+	if (Change(cullFace, mode, RENDER_STAT_STATE_CHANGES))
+	{
+		glCullFace(mode);
+	}
+}
+
+void GLState::ForgetProgram(GLuint program)
+{
+	if (GLState::program == program) { GLState::program = 0; }
+}
+
+void GLState::ForgetVertexArray(GLuint vertexArray)
+{
+	if (GLState::vertexArray == vertexArray) { GLState::vertexArray = 0; }
+}
+
+void GLState::ForgetBuffer(GLuint buffer)
+{
+	for (int i = 0; i < BUFFER_TARGET_COUNT; i++)
+	{
+		if (buffers[i] == buffer) { buffers[i] = 0; }
+	}
+	for (int i = 0; i < GL_STATE_UNIFORM_BINDINGS; i++)
+	{
+		if (uniformRanges[i].buffer == buffer) { uniformRanges[i].buffer = 0; }
+	}
+}
+
+void GLState::ForgetTexture(GLuint texture)
+{
+	for (int unit = 0; unit < GL_STATE_TEXTURE_UNITS; unit++)
+	{
+		for (int i = 0; i < TEXTURE_TARGET_COUNT; i++)
+		{
+			if (textures[unit][i] == texture) { textures[unit][i] = 0; }
+		}
+	}
+}
+
+void GLState::ForgetFramebuffer(GLuint framebuffer)
+{
+	if (drawFramebuffer == framebuffer) { drawFramebuffer = 0; }
+	if (readFramebuffer == framebuffer) { readFramebuffer = 0; }
+}
+
+int GLState::GetBufferTarget(GLenum target)
+{
+	switch (target)
+	{
+	case GL_ARRAY_BUFFER: return BUFFER_ARRAY;
+	case GL_UNIFORM_BUFFER: return BUFFER_UNIFORM;
+	case GL_TEXTURE_BUFFER: return BUFFER_TEXTURE;
+	case GL_PIXEL_PACK_BUFFER: return BUFFER_PIXEL_PACK;
+	default: return -1;
+	}
+}
+
+int GLState::GetTextureTarget(GLenum target)
+{
+	switch (target)
+	{
+	case GL_TEXTURE_2D: return TEXTURE_2D;
+	case GL_TEXTURE_CUBE_MAP: return TEXTURE_CUBE_MAP;
+	case GL_TEXTURE_2D_ARRAY: return TEXTURE_2D_ARRAY;
+	case GL_TEXTURE_BUFFER: return TEXTURE_BUFFER;
+	default: return -1;
+	}
+}
+
+int GLState::GetCapability(GLenum capability)
+{
+	switch (capability)
+	{
+	case GL_DEPTH_TEST: return CAPABILITY_DEPTH_TEST;
+	case GL_CULL_FACE: return CAPABILITY_CULL_FACE;
+	case GL_SCISSOR_TEST: return CAPABILITY_SCISSOR_TEST;
+	case GL_CLIP_DISTANCE0: return CAPABILITY_CLIP_DISTANCE0;
+	case GL_BLEND: return CAPABILITY_BLEND;
+	default: return -1;
+	}
+}
+
+bool GLState::Change(GLuint& cached, GLuint value, RenderStat stat)
+{
+	if (cached == value)
+	{
+		RenderStats::Add(RENDER_STAT_REDUNDANT_STATE);
+		return false;
+	}
+	cached = value;
+	RenderStats::Add(stat);
+	return true;
+}
@@ -0,0 +1,81 @@
+/*
+GL state cache
+
+Thin tracker of OpenGL state the engine changes most: program, VAO, buffer bindings, uniform buffer ranges of binding points,
+textures bound to each texture unit, draw and read framebuffer, viewport, scissor, enable bits (depth test, cull face, scissor test, clip distance 0, blend), depth mask and cull face.
+Engine code calls GLState instead of GL, calls that would set the value already set never reach the driver.
+Binds that reach the driver are counted in render stats (program, texture, VAO, framebuffer binds, other state changes),
+calls that were filtered out as RENDER_STAT_REDUNDANT_STATE.
+
+Cache has to know about every change:
+- Invalidate() marks everything unknown (next call of each kind goes to the driver), called at the start of every frame, so changes done
+  outside of the frame (window resize, context creation, ImGui backend which restores what it changes anyway) don't matter.
+- Deleting a bound object unbinds it in GL, Forget* has to be called after glDelete* so a new object with reused name isn't skipped.
+- Element array buffer binding is part of the VAO, BindBuffer passes it to the driver always.
+- Binding a uniform buffer range binds the buffer to GL_UNIFORM_BUFFER too, the cache follows that.
+Texture binds with unit (sampling) switch active texture unit only when the binding on the unit really changes.
+Texture binds without unit (creating and updating textures) use whatever unit is active.
+Units above GL_STATE_TEXTURE_UNITS and unknown targets and capabilities are not cached.
+*/
+
+#pragma once
+
+#include <GL\glew.h>
+
+#include "CommonValues.h"
+#include "RenderStats.h"
+
+class GLState
+{
+public:
+	static void Invalidate();
+
+	static void UseProgram(GLuint program);
+	static void BindVertexArray(GLuint vertexArray);
+	static void BindBuffer(GLenum target, GLuint buffer);
+	static void BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size); //Only GL_UNIFORM_BUFFER points are cached
+	static void BindTexture(GLuint unit, GLenum target, GLuint texture); //For sampling, unit is a number (not GL_TEXTURE0 + unit)
+	static void BindTexture(GLenum target, GLuint texture); //On active unit, for creating and updating textures
+	static void ActiveTexture(GLuint unit);
+	static void BindFramebuffer(GLenum target, GLuint framebuffer); //GL_FRAMEBUFFER binds both draw and read framebuffer
+
+	static void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+	static void Scissor(GLint x, GLint y, GLsizei width, GLsizei height);
+	static void Enable(GLenum capability) { SetEnabled(capability, true); }
+	static void Disable(GLenum capability) { SetEnabled(capability, false); }
+	static void SetEnabled(GLenum capability, bool enabled);
+	static void DepthMask(GLboolean enabled);
+	static void CullFace(GLenum mode);
+
+	static void ForgetProgram(GLuint program);
+	static void ForgetVertexArray(GLuint vertexArray);
+	static void ForgetBuffer(GLuint buffer);
+	static void ForgetTexture(GLuint texture);
+	static void ForgetFramebuffer(GLuint framebuffer);
+
+private:
+	enum BufferTarget { BUFFER_ARRAY, BUFFER_UNIFORM, BUFFER_TEXTURE, BUFFER_PIXEL_PACK, BUFFER_TARGET_COUNT };
+	enum TextureTarget { TEXTURE_2D, TEXTURE_CUBE_MAP, TEXTURE_2D_ARRAY, TEXTURE_BUFFER, TEXTURE_TARGET_COUNT };
+	enum Capability { CAPABILITY_DEPTH_TEST, CAPABILITY_CULL_FACE, CAPABILITY_SCISSOR_TEST, CAPABILITY_CLIP_DISTANCE0, CAPABILITY_BLEND, CAPABILITY_COUNT };
+
+	static const GLuint UNKNOWN = 0xFFFFFFFF; //No GL name or enum has this value
+
+	static GLuint program, vertexArray, drawFramebuffer, readFramebuffer, activeUnit;
+	static GLuint buffers[BUFFER_TARGET_COUNT];
+	struct BufferRange
+	{
+		GLuint buffer;
+		GLintptr offset;
+		GLsizeiptr size;
+	};
+	static BufferRange uniformRanges[GL_STATE_UNIFORM_BINDINGS];
+	static GLuint textures[GL_STATE_TEXTURE_UNITS][TEXTURE_TARGET_COUNT];
+	static GLint viewport[4], scissor[4];
+	static GLuint capabilities[CAPABILITY_COUNT]; //0, 1 or UNKNOWN
+	static GLuint depthMask, cullFace;
+
+	static int GetBufferTarget(GLenum target);
+	static int GetTextureTarget(GLenum target);
+	static int GetCapability(GLenum capability);
+	static bool Change(GLuint& cached, GLuint value, RenderStat stat); //Updates cached value, false (and counted as redundant) when it was already set
+};
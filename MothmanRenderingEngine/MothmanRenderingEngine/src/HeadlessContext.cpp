@@ -0,0 +1,261 @@
+#include "HeadlessContext.h"
+
+#include "GLState.h"
+
+HeadlessContext::HeadlessContext()
+{
+	width = 0;
+	height = 0;
+	FBO = 0;
+	colorRenderbuffer = 0;
+	for (int i = 0; i < HEADLESS_READBACK_BUFFERS; i++)
+	{
+		readbackBuffers[i] = 0;
+		readbackFrames[i] = -1;
+	}
+	nextReadback = 0;
+	queuedReadbacks = 0;
+
+#ifdef MOTHMAN_HEADLESS_EGL
+	display = EGL_NO_DISPLAY;
+	context = EGL_NO_CONTEXT;
+	surface = EGL_NO_SURFACE;
+#endif
+}
+
+bool HeadlessContext::Init(GLuint width, GLuint height)
+{
+	this->width = width;
+	this->height = height;
+
+#ifdef MOTHMAN_HEADLESS_EGL
+	if (!CreateContext())
+	{
+		return false;
+	}
+#else
+	printf("ERROR: Headless mode needs build with MOTHMAN_HEADLESS_EGL defined (and libEGL linked)\n");
+	return false;
+#endif
+
+	glewExperimental = GL_TRUE;
+	GLenum error = glewInit();
+	if (error != GLEW_OK && error != GLEW_ERROR_NO_GLX_DISPLAY) //Without X server GLX part fails after OpenGL functions are already loaded
+	{
+		printf("ERROR: GLEW initialization failed: %s\n", glewGetErrorString(error));
+		return false;
+	}
+
+	printf("LOG: Headless context: %s, %s\n", glGetString(GL_RENDERER), glGetString(GL_VERSION));
+	return CreateFramebuffer();
+}
+
+#ifdef MOTHMAN_HEADLESS_EGL
+bool HeadlessContext::CreateContext()
+{
+	const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (getPlatformDisplay != nullptr && HasExtension(clientExtensions, "EGL_MESA_platform_surfaceless"))
+	{
+		display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+	}
+	if (display == EGL_NO_DISPLAY)
+	{
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	}
+
+	EGLint major, minor;
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+	{
+		printf("ERROR: EGL display initialization failed\n");
+		return false;
+	}
+
+	const EGLint configAttributes[] = {
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_NONE
+	};
+	EGLConfig config;
+	EGLint configCount = 0;
+	if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0)
+	{
+		printf("ERROR: No EGL config supporting desktop OpenGL\n");
+		return false;
+	}
+
+	eglBindAPI(EGL_OPENGL_API);
+	const EGLint contextAttributes[] = {
+		EGL_CONTEXT_MAJOR_VERSION_KHR, 3,
+		EGL_CONTEXT_MINOR_VERSION_KHR, 3,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+		EGL_NONE
+	};
+	context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+	if (context == EGL_NO_CONTEXT)
+	{
+		printf("ERROR: EGL OpenGL 3.3 core context creation failed (0x%x)\n", eglGetError());
+		return false;
+	}
+
+	if (!HasExtension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context")) //Context has to be current with some surface
+	{
+		const EGLint surfaceAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+		surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+	}
+
+	if (!eglMakeCurrent(display, surface, surface, context))
+	{
+		printf("ERROR: EGL context could not be made current (0x%x)\n", eglGetError());
+		return false;
+	}
+	return true;
+}
+#endif
+
+bool HeadlessContext::CreateFramebuffer()
+{
+	glGenRenderbuffers(1, &colorRenderbuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, colorRenderbuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &FBO);
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, FBO);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRenderbuffer);
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+	if (status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		printf("ERROR: Headless framebuffer is not complete (0x%x)\n", status);
+		return false;
+	}
+
+	glGenBuffers(HEADLESS_READBACK_BUFFERS, readbackBuffers);
+	for (int i = 0; i < HEADLESS_READBACK_BUFFERS; i++)
+	{
+		GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, readbackBuffers[i]);
+		glBufferData(GL_PIXEL_PACK_BUFFER, width * height * 3, nullptr, GL_STREAM_READ);
+	}
+	GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	return true;
+}
+
+bool HeadlessContext::ReadFrame(int frame, std::vector<unsigned char>& pixels, int& readFrame)
+{
+	bool read = false;
+	if (queuedReadbacks == HEADLESS_READBACK_BUFFERS) //Ring is full, next buffer holds the oldest frame
+	{
+		readFrame = readbackFrames[nextReadback];
+		MapReadback(nextReadback, pixels);
+		read = true;
+	}
+
+	GLState::BindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+	GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, readbackBuffers[nextReadback]);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, nullptr); //Into the buffer, doesn't wait for the frame to finish
+	GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	GLState::BindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+	readbackFrames[nextReadback] = frame;
+	nextReadback = (nextReadback + 1) % HEADLESS_READBACK_BUFFERS;
+	queuedReadbacks++;
+	return read;
+}
+
+bool HeadlessContext::FlushFrame(std::vector<unsigned char>& pixels, int& readFrame)
+{
+	if (queuedReadbacks == 0)
+	{
+		return false;
+	}
+
+	int oldest = (nextReadback + HEADLESS_READBACK_BUFFERS - queuedReadbacks) % HEADLESS_READBACK_BUFFERS;
+	readFrame = readbackFrames[oldest];
+	MapReadback(oldest, pixels);
+	return true;
+}
+
+void HeadlessContext::MapReadback(int index, std::vector<unsigned char>& pixels)
+{
+	pixels.resize(width * height * 3);
+	GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, readbackBuffers[index]);
+	void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, pixels.size(), GL_MAP_READ_BIT);
+	if (data != nullptr)
+	{
+		memcpy(&pixels[0], data, pixels.size());
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	readbackFrames[index] = -1;
+	queuedReadbacks--;
+}
+
+bool HeadlessContext::WriteImage(const std::string& path, const std::vector<unsigned char>& pixels)
+{
+	FILE* file = fopen(path.c_str(), "wb");
+	if (file == nullptr)
+	{
+		printf("ERROR: Could not open %s for writing\n", path.c_str());
+		return false;
+	}
+
+	fprintf(file, "P6\n%u %u\n255\n", width, height);
+	size_t rowSize = width * 3;
+	for (GLuint row = 0; row < height; row++) //OpenGL rows start at the bottom
+	{
+		fwrite(&pixels[(height - 1 - row) * rowSize], 1, rowSize, file);
+	}
+	fclose(file);
+	return true;
+}
+
+void HeadlessContext::Release()
+{
+	if (readbackBuffers[0] != 0)
+	{
+		glDeleteBuffers(HEADLESS_READBACK_BUFFERS, readbackBuffers);
+		for (int i = 0; i < HEADLESS_READBACK_BUFFERS; i++) { readbackBuffers[i] = 0; }
+	}
+	if (FBO != 0) { glDeleteFramebuffers(1, &FBO); FBO = 0; }
+	if (colorRenderbuffer != 0) { glDeleteRenderbuffers(1, &colorRenderbuffer); colorRenderbuffer = 0; }
+
+#ifdef MOTHMAN_HEADLESS_EGL
+	if (display != EGL_NO_DISPLAY)
+	{
+		eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (surface != EGL_NO_SURFACE) { eglDestroySurface(display, surface); }
+		if (context != EGL_NO_CONTEXT) { eglDestroyContext(display, context); }
+		eglTerminate(display);
+		display = EGL_NO_DISPLAY;
+		context = EGL_NO_CONTEXT;
+		surface = EGL_NO_SURFACE;
+	}
+#endif
+}
+
+bool HeadlessContext::HasExtension(const char* extensions, const char* name)
+{
+	if (extensions == nullptr)
+	{
+		return false;
+	}
+
+	size_t length = strlen(name);
+	for (const char* found = strstr(extensions, name); found != nullptr; found = strstr(found + length, name))
+	{
+		bool start = found == extensions || found[-1] == ' ';
+		bool end = found[length] == ' ' || found[length] == '\0';
+		if (start && end)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+HeadlessContext::~HeadlessContext()
+{
+}
@@ -0,0 +1,84 @@
+/*
+Headless context
+
+OpenGL 3.3 core context without a window or display, for producing frames in batch jobs on render nodes.
+EGL is used (Mesa llvmpipe and GPU drivers both provide it): display comes from EGL_MESA_platform_surfaceless when available, otherwise
+from the default display, and context is made current without surface (EGL_KHR_surfaceless_context) or with 1x1 pbuffer.
+Built only with MOTHMAN_HEADLESS_EGL defined (link libEGL), without it Init fails.
+
+Nothing is presented, so offscreen framebuffer (RGBA8 renderbuffer) takes place of the default framebuffer (RenderGraph::SetScreenFramebuffer).
+Readback: glReadPixels goes into a ring of HEADLESS_READBACK_BUFFERS pixel buffers and frame is mapped only when the ring comes around,
+so CPU keeps submitting frames instead of waiting for each one to finish.
+Images are written as binary PPM (no dependency, any image tool converts them).
+*/
+
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <string>
+
+#include <GL\glew.h>
+
+#ifdef MOTHMAN_HEADLESS_EGL
+#include <EGL\egl.h>
+#include <EGL\eglext.h>
+#endif
+
+#include "CommonValues.h"
+
+struct HeadlessSettings //Filled from command line
+{
+	bool enabled = false;
+	GLuint width = 1280;
+	GLuint height = 720;
+	int frameCount = 100;
+	float frameRate = 30.0f; //Time step of camera path and animations, not a limit
+	std::string scene; //Comma separated scene options
+	std::string cameraPath; //File with camera keyframes, camera stays in start position when empty
+	std::string outputDirectory; //Images are not read back when empty (measures rendering only)
+	bool benchmark = false; //Measure frames after warm-up and write report
+	int warmupFrames = 30;
+	std::string reportPath = "benchmark"; //Without extension, .csv and .json are written
+};
+
+class HeadlessContext
+{
+public:
+	HeadlessContext();
+
+	bool Init(GLuint width, GLuint height); //Create context, make it current, initialize GLEW and create offscreen framebuffer
+
+	GLuint GetFramebuffer() { return FBO; }
+	GLuint GetWidth() { return width; }
+	GLuint GetHeight() { return height; }
+
+	bool ReadFrame(int frame, std::vector<unsigned char>& pixels, int& readFrame); //Queue readback of the frame, returns oldest queued frame when the ring is full
+	bool FlushFrame(std::vector<unsigned char>& pixels, int& readFrame); //Returns remaining queued frames one by one
+
+	bool WriteImage(const std::string& path, const std::vector<unsigned char>& pixels); //Binary PPM, rows flipped to top-down
+
+	void Release();
+
+	~HeadlessContext();
+
+private:
+	GLuint width, height;
+	GLuint FBO, colorRenderbuffer;
+	GLuint readbackBuffers[HEADLESS_READBACK_BUFFERS];
+	int readbackFrames[HEADLESS_READBACK_BUFFERS]; //Frame in each buffer, -1 when empty
+	int nextReadback, queuedReadbacks;
+
+#ifdef MOTHMAN_HEADLESS_EGL
+	EGLDisplay display;
+	EGLContext context;
+	EGLSurface surface; //Only when surfaceless context is not supported
+
+	bool CreateContext();
+#endif
+
+	bool CreateFramebuffer();
+	void MapReadback(int index, std::vector<unsigned char>& pixels);
+	static bool HasExtension(const char* extensions, const char* name);
+};
@@ -0,0 +1,229 @@
+#include "JobSystem.h"
+
+#include <stdio.h>
+#include <algorithm>
+
+JobSystem::Queue JobSystem::queues[JOB_SYSTEM_MAX_WORKERS + 1];
+std::vector<std::thread> JobSystem::workers;
+unsigned int JobSystem::workerCount = 0;
+std::atomic<int> JobSystem::queuedJobs(0);
+std::mutex JobSystem::sleepMutex;
+std::condition_variable JobSystem::wakeUp;
+bool JobSystem::stopping = false;
+thread_local unsigned int JobSystem::threadIndex = 0;
+
+void JobSystem::Start(unsigned int workerCount)
+{
+	Stop();
+
+	JobSystem::workerCount = std::min(workerCount, (unsigned int)JOB_SYSTEM_MAX_WORKERS);
+	for (unsigned int thread = 1; thread <= JobSystem::workerCount; thread++)
+	{
+		workers.push_back(std::thread(&JobSystem::WorkerLoop, thread));
+	}
+	printf("LOG: Job system started with %u worker threads\n", JobSystem::workerCount);
+}
+
+void JobSystem::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	wakeUp.notify_all();
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		workers[i].join();
+	}
+	workers.clear();
+	workerCount = 0;
+	stopping = false;
+}
+
+void JobSystem::Schedule(const char* name, std::function<void()> function, JobCounter* counter, JobCounter* dependency)
+{
+	Job job;
+	job.function = std::move(function);
+	job.name = name;
+	job.counter = counter;
+
+	if (counter != nullptr)
+	{
+		std::lock_guard<std::mutex> lock(counter->mutex);
+		counter->pending++;
+	}
+	if (dependency != nullptr)
+	{
+		std::lock_guard<std::mutex> lock(dependency->mutex);
+		if (dependency->pending.load() != 0) //Pushed by the thread that finishes the last job of the dependency
+		{
+			dependency->dependents.push_back(std::move(job));
+			return;
+		}
+	}
+	Push(job);
+}
+
+void JobSystem::Wait(JobCounter* counter)
+{
+	while (counter->pending.load() != 0)
+	{
+		Job job;
+		if (Pop(job))
+		{
+			Run(job);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+	std::lock_guard<std::mutex> lock(counter->mutex); //Thread that finished the last job may still be taking dependents out of the counter
+}
+
+void JobSystem::ParallelFor(const char* name, size_t count, size_t grain, const std::function<void(size_t, size_t)>& function)
+{
+	grain = std::max(grain, (size_t)1);
+	if (count == 0)
+	{
+		return;
+	}
+	if (count <= grain || workerCount == 0)
+	{
+		function(0, count);
+		return;
+	}
+
+	JobCounter counter;
+	for (size_t first = 0; first < count; first += grain)
+	{
+		size_t last = std::min(first + grain, count);
+		Schedule(name, [&function, first, last]() { function(first, last); }, &counter);
+	}
+	Wait(&counter);
+}
+
+void JobSystem::CollectTimings(std::vector<JobTiming>& timings)
+{
+	for (unsigned int thread = 0; thread <= workerCount; thread++)
+	{
+		std::lock_guard<std::mutex> lock(queues[thread].mutex);
+		timings.insert(timings.end(), queues[thread].timings.begin(), queues[thread].timings.end());
+		queues[thread].timings.clear();
+	}
+}
+
+unsigned int JobSystem::GetDefaultWorkerCount()
+{
+	unsigned int hardwareThreads = std::thread::hardware_concurrency(); //0 when unknown
+	return std::min(hardwareThreads > 1 ? hardwareThreads - 1 : 0u, (unsigned int)JOB_SYSTEM_MAX_WORKERS);
+}
+
+void JobSystem::WorkerLoop(unsigned int thread)
+{
+	threadIndex = thread;
+	while (true)
+	{
+		Job job;
+		if (Pop(job))
+		{
+			Run(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		wakeUp.wait(lock, []() { return stopping || queuedJobs.load() > 0; });
+		if (stopping)
+		{
+			return;
+		}
+	}
+}
+
+void JobSystem::Push(const Job& job)
+{
+	Queue& queue = queues[threadIndex];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back(job);
+	}
+	queuedJobs++;
+
+	if (workerCount > 0)
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex); //Worker checking queuedJobs right now either sees the job or is already waiting
+		}
+		wakeUp.notify_one();
+	}
+}
+
+bool JobSystem::Pop(Job& job)
+{
+	if (queuedJobs.load() <= 0)
+	{
+		return false;
+	}
+
+	unsigned int queueCount = workerCount + 1;
+	for (unsigned int i = 0; i < queueCount; i++)
+	{
+		Queue& queue = queues[(threadIndex + i) % queueCount];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.jobs.empty())
+		{
+			continue;
+		}
+
+		if (i == 0) //Own deque, newest job
+		{
+			job = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+		}
+		else //Stealing, oldest job
+		{
+			job = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+		}
+		queuedJobs--;
+		return true;
+	}
+	return false;
+}
+
+void JobSystem::Run(Job& job)
+{
+	JobTiming timing;
+	timing.name = job.name;
+	timing.thread = threadIndex;
+	timing.begin = std::chrono::steady_clock::now();
+	job.function();
+	timing.end = std::chrono::steady_clock::now();
+	{
+		std::lock_guard<std::mutex> lock(queues[threadIndex].mutex);
+		queues[threadIndex].timings.push_back(timing);
+	}
+
+	Finish(job.counter); //After the timing is stored, so timings of waited jobs are there when Wait returns
+}
+
+void JobSystem::Finish(JobCounter* counter)
+{
+	if (counter == nullptr)
+	{
+		return;
+	}
+
+	std::vector<Job> ready;
+	{
+		std::lock_guard<std::mutex> lock(counter->mutex);
+		if (--counter->pending == 0)
+		{
+			ready.swap(counter->dependents);
+		}
+	}
+	for (size_t i = 0; i < ready.size(); i++)
+	{
+		Push(ready[i]);
+	}
+}
@@ -0,0 +1,113 @@
+/*
+Job system
+
+CPU work of the frame that doesn't touch OpenGL (animation, scene submission and culling, occlusion culling, terrain quadtree update,
+light cluster assignment) runs as jobs on a pool of worker threads, main thread keeps the OpenGL context and waits for a result only
+right before it needs it, running jobs itself while it waits.
+
+Scheduling (work stealing):
+- Every thread has its own deque of jobs, main thread is thread 0, workers are 1..N. Job scheduled from a thread goes to its own deque.
+  Owner pushes and pops at the back (newest job first, its data is likely still in cache), idle threads steal from the front of other
+  deques (oldest job, usually the biggest piece of work). Deques are guarded by a mutex each, threads mostly touch their own so it's rarely contended.
+- Jobs scheduled from main thread are not run by it until it waits, workers steal them, so main thread can issue GL calls meanwhile.
+- Idle workers sleep on a condition variable and are woken when a job is pushed.
+- With 0 workers everything still works, jobs run on main thread inside Wait.
+
+Dependencies: job can have a counter, it is incremented when the job is scheduled and decremented when it finishes. Wait returns when
+the counter reaches zero. Job scheduled with a dependency counter that isn't zero is kept by that counter and pushed when it reaches zero,
+so chains (animation -> scene submission -> occlusion culling) don't block any thread. Counter has to outlive its jobs and every Wait on it.
+Several jobs can share one counter, job depending on all of them depends on the counter.
+
+ParallelFor splits range into chunks of grain size, schedules them as jobs and waits (works inside jobs too, waiting thread helps).
+Range of one chunk, or no workers, runs inline on calling thread.
+
+Timing: every job run is recorded (name, thread, begin, end) by the thread that ran it, CollectTimings moves out records of jobs finished so far
+(simulation jobs of next frames may still run, FramePipeline), main thread passes them to FrameTimer (job sections, job lanes of profiler and Chrome trace).
+Job names have to be string literals (records keep the pointer).
+
+Rules for job code: no OpenGL, no GLState, no FrameTimer, no RenderStats (plain counters of main thread, jobs keep counts in their own results).
+Start and Stop only when no job is pending (between frames).
+*/
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+
+#include "CommonValues.h"
+
+struct JobTiming
+{
+	const char* name;
+	unsigned int thread; //0 is main thread
+	std::chrono::steady_clock::time_point begin, end;
+};
+
+class JobCounter;
+
+struct Job
+{
+	std::function<void()> function;
+	const char* name;
+	JobCounter* counter; //Can be nullptr
+};
+
+class JobCounter
+{
+public:
+	JobCounter() : pending(0) {}
+
+	bool IsDone() { return pending.load() == 0; }
+
+private:
+	friend class JobSystem;
+
+	std::atomic<unsigned int> pending; //Changed only with mutex locked, read without it
+	std::mutex mutex;
+	std::vector<Job> dependents; //Jobs waiting for this counter to reach zero
+};
+
+class JobSystem
+{
+public:
+	static void Start(unsigned int workerCount); //Stops running workers first, count is clamped to JOB_SYSTEM_MAX_WORKERS
+	static void Stop();
+
+	static void Schedule(const char* name, std::function<void()> function, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+	static void Wait(JobCounter* counter); //Runs jobs until counter reaches zero
+	static void ParallelFor(const char* name, size_t count, size_t grain, const std::function<void(size_t, size_t)>& function); //function(first, last), exclusive end
+
+	static void CollectTimings(std::vector<JobTiming>& timings); //Appends records of all threads, jobs still running are collected next time
+	static unsigned int GetWorkerCount() { return workerCount; }
+	static unsigned int GetDefaultWorkerCount(); //Hardware threads minus main thread
+	static unsigned int GetThreadIndex() { return threadIndex; } //0 on main thread and threads outside of the pool
+
+private:
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<Job> jobs;
+		std::vector<JobTiming> timings;
+	};
+
+	static Queue queues[JOB_SYSTEM_MAX_WORKERS + 1];
+	static std::vector<std::thread> workers;
+	static unsigned int workerCount;
+	static std::atomic<int> queuedJobs;
+	static std::mutex sleepMutex;
+	static std::condition_variable wakeUp;
+	static bool stopping; //Guarded by sleepMutex
+	static thread_local unsigned int threadIndex;
+
+	static void WorkerLoop(unsigned int thread);
+	static void Push(const Job& job);
+	static bool Pop(Job& job); //Own deque first, then steal
+	static void Run(Job& job);
+	static void Finish(JobCounter* counter);
+};
@@ -0,0 +1,304 @@
+#include "LightClusters.h"
+
+#include <string.h>
+
+#include "RenderStats.h"
+#include "GLState.h"
+#include "JobSystem.h"
+
+static const unsigned int CLUSTER_JOBS_MIN_LIGHTS = 32; //Below this scheduling jobs costs more than assignment itself
+static const int CLUSTER_SLICES_PER_JOB = 6;
+
+LightClusters::LightClusters()
+{
+	lightDataBuffer = 0;
+	lightDataTexture = 0;
+	gridBuffer = 0;
+	gridTexture = 0;
+	indexBuffer = 0;
+	indexTexture = 0;
+
+	fieldOfView = 0.0f;
+	aspectRatio = 0.0f;
+	nearPlane = 0.0f;
+	farPlane = 0.0f;
+	tileWidth = 1;
+	tileHeight = 1;
+
+	maxClusterLightCount = 0;
+	overflowCount = 0;
+	jobCount = 0;
+}
+
+bool LightClusters::Init()
+{
+	CreateBufferTexture(lightDataBuffer, lightDataTexture, GL_RGBA32F);
+	CreateBufferTexture(gridBuffer, gridTexture, GL_RG32UI);
+	CreateBufferTexture(indexBuffer, indexTexture, GL_R16UI);
+
+	clusterLights.resize(CLUSTER_COUNT * MAX_LIGHTS_PER_CLUSTER);
+	grid.resize(CLUSTER_COUNT);
+	return true;
+}
+
+void LightClusters::CreateBufferTexture(GLuint& buffer, GLuint& texture, GLenum format)
+{
+	glGenBuffers(1, &buffer);
+	GLState::BindBuffer(GL_TEXTURE_BUFFER, buffer);
+	glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_STREAM_DRAW);
+
+	glGenTextures(1, &texture);
+	GLState::BindTexture(GL_TEXTURE_BUFFER, texture);
+	glTexBuffer(GL_TEXTURE_BUFFER, format, buffer); //Texture keeps pointing to the buffer when its data is respecified
+
+	GLState::BindTexture(GL_TEXTURE_BUFFER, 0);
+	GLState::BindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightClusters::UploadBuffer(GLuint buffer, const void* data, size_t size)
+{
+	static const glm::uvec4 empty = glm::uvec4(0);
+	if (size == 0) //Buffer textures can not be empty
+	{
+		data = &empty;
+		size = sizeof(empty);
+	}
+
+	GLState::BindBuffer(GL_TEXTURE_BUFFER, buffer);
+	glBufferData(GL_TEXTURE_BUFFER, size, data, GL_STREAM_DRAW);
+	RenderStats::Add(RENDER_STAT_BUFFER_UPLOAD_BYTES, size);
+	GLState::BindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightClusters::UpdateClusterBounds()
+{
+	float tanHalfFOV = tanf(glm::radians(fieldOfView) * 0.5f);
+
+	for (int z = 0; z < CLUSTER_GRID_Z; z++)
+	{
+		float sliceNear = nearPlane * powf(farPlane / nearPlane, (float)z / CLUSTER_GRID_Z);
+		float sliceFar = nearPlane * powf(farPlane / nearPlane, (float)(z + 1) / CLUSTER_GRID_Z);
+
+		for (int y = 0; y < CLUSTER_GRID_Y; y++)
+		{
+			float bottom = (-1.0f + 2.0f * y / CLUSTER_GRID_Y) * tanHalfFOV; //Tile edges at view depth 1
+			float top = (-1.0f + 2.0f * (y + 1) / CLUSTER_GRID_Y) * tanHalfFOV;
+
+			for (int x = 0; x < CLUSTER_GRID_X; x++)
+			{
+				float left = (-1.0f + 2.0f * x / CLUSTER_GRID_X) * tanHalfFOV * aspectRatio;
+				float right = (-1.0f + 2.0f * (x + 1) / CLUSTER_GRID_X) * tanHalfFOV * aspectRatio;
+
+				//Tile edges scale with depth, box has to contain both near and far face of the cluster
+				int cluster = x + y * CLUSTER_GRID_X + z * CLUSTERS_PER_SLICE;
+				boundsMinX[cluster] = glm::min(left * sliceNear, left * sliceFar);
+				boundsMaxX[cluster] = glm::max(right * sliceNear, right * sliceFar);
+				boundsMinY[cluster] = glm::min(bottom * sliceNear, bottom * sliceFar);
+				boundsMaxY[cluster] = glm::max(top * sliceNear, top * sliceFar);
+				boundsMinZ[cluster] = -sliceFar; //Camera looks along -Z
+				boundsMaxZ[cluster] = -sliceNear;
+			}
+		}
+	}
+}
+
+int LightClusters::GetSlice(float depth)
+{
+	if (depth <= nearPlane) { return 0; }
+
+	int slice = (int)floorf(logf(depth / nearPlane) / logf(farPlane / nearPlane) * CLUSTER_GRID_Z);
+	return glm::min(slice, CLUSTER_GRID_Z - 1);
+}
+
+bool LightClusters::ConeIntersectsSphere(const ClusterLight& light, const glm::vec3& center, float radius)
+{
+	glm::vec3 offset = center - light.position;
+	float offsetLengthSquared = glm::dot(offset, offset);
+	float alongAxis = glm::dot(offset, light.direction);
+	float distanceToCone = light.cosAngle * sqrtf(glm::max(offsetLengthSquared - alongAxis * alongAxis, 0.0f)) - alongAxis * light.sinAngle; //Distance from sphere center to the side of the cone
+
+	bool outsideAngle = distanceToCone > radius;
+	bool behindFar = alongAxis > radius + light.range;
+	bool behindApex = alongAxis < -radius;
+	return !(outsideAngle || behindFar || behindApex);
+}
+
+void LightClusters::AssignLights(int firstSlice, int lastSlice, unsigned int* overflow)
+{
+	std::vector<uint32_t> visibleClusters;
+	visibleClusters.reserve(CLUSTERS_PER_SLICE);
+
+	for (size_t i = 0; i < lights.size(); i++)
+	{
+		const ClusterLight& light = lights[i];
+		if (light.range <= 0.0f) { continue; }
+
+		float depth = -light.position.z;
+		if (depth + light.range < nearPlane || depth - light.range > farPlane) { continue; } //In front of or behind the grid
+
+		int sliceStart = glm::max(GetSlice(depth - light.range), firstSlice);
+		int sliceEnd = glm::min(GetSlice(depth + light.range), lastSlice);
+		for (int slice = sliceStart; slice <= sliceEnd; slice++)
+		{
+			int first = slice * CLUSTERS_PER_SLICE;
+			visibleClusters.clear();
+			Culling::CullBoxesBySphere(light.position, light.range, &boundsMinX[first], &boundsMinY[first], &boundsMinZ[first], &boundsMaxX[first], &boundsMaxY[first], &boundsMaxZ[first], CLUSTERS_PER_SLICE, visibleClusters);
+
+			for (size_t j = 0; j < visibleClusters.size(); j++)
+			{
+				int cluster = first + visibleClusters[j];
+				if (light.spot)
+				{
+					glm::vec3 boundsMin = glm::vec3(boundsMinX[cluster], boundsMinY[cluster], boundsMinZ[cluster]);
+					glm::vec3 boundsMax = glm::vec3(boundsMaxX[cluster], boundsMaxY[cluster], boundsMaxZ[cluster]);
+					if (!ConeIntersectsSphere(light, (boundsMin + boundsMax) * 0.5f, glm::length(boundsMax - boundsMin) * 0.5f)) { continue; }
+				}
+
+				unsigned int& count = clusterLightCounts[cluster];
+				if (count < MAX_LIGHTS_PER_CLUSTER)
+				{
+					clusterLights[cluster * MAX_LIGHTS_PER_CLUSTER + count] = (uint16_t)i;
+					count++;
+				}
+				else
+				{
+					(*overflow)++;
+				}
+			}
+		}
+	}
+}
+
+void LightClusters::Assign(Camera* camera, GLuint screenWidth, GLuint screenHeight, PointLight* pointLights, unsigned int pointLightCount, SpotLight* spotLights, unsigned int spotLightCount)
+{
+	if (camera->GetFOV() != fieldOfView || camera->GetAspectRatio() != aspectRatio || camera->GetNearPlane() != nearPlane || camera->GetFarPlane() != farPlane)
+	{
+		fieldOfView = camera->GetFOV();
+		aspectRatio = camera->GetAspectRatio();
+		nearPlane = camera->GetNearPlane();
+		farPlane = camera->GetFarPlane();
+		UpdateClusterBounds();
+	}
+	tileWidth = (screenWidth + CLUSTER_GRID_X - 1) / CLUSTER_GRID_X;
+	tileHeight = (screenHeight + CLUSTER_GRID_Y - 1) / CLUSTER_GRID_Y;
+
+	//Lights in view space, point lights first
+	glm::mat4 view = camera->GetViewMatrix();
+	lights.clear();
+	for (unsigned int i = 0; i < pointLightCount + spotLightCount; i++)
+	{
+		bool spot = i >= pointLightCount;
+		PointLight* light = spot ? &spotLights[i - pointLightCount] : &pointLights[i];
+
+		ClusterLight clusterLight;
+		clusterLight.position = glm::vec3(view * glm::vec4(light->GetPosition(), 1.0f));
+		clusterLight.range = light->GetRange();
+		clusterLight.direction = glm::vec3(0.0f);
+		clusterLight.cosAngle = -1.0f;
+		clusterLight.sinAngle = 0.0f;
+		clusterLight.spot = spot;
+		if (spot)
+		{
+			SpotLight* spotLight = (SpotLight*)light;
+			clusterLight.direction = glm::normalize(glm::mat3(view) * spotLight->GetDirection());
+			clusterLight.cosAngle = spotLight->GetProcEdge();
+			clusterLight.sinAngle = sinf(glm::radians(spotLight->GetEdge()));
+		}
+		lights.push_back(clusterLight);
+	}
+
+	//Assignment, every job owns its slices
+	memset(clusterLightCounts, 0, sizeof(clusterLightCounts));
+	memset(sliceOverflows, 0, sizeof(sliceOverflows));
+	int slicesPerJob = CLUSTER_GRID_Z;
+	if (lights.size() >= CLUSTER_JOBS_MIN_LIGHTS && JobSystem::GetWorkerCount() > 0)
+	{
+		slicesPerJob = CLUSTER_SLICES_PER_JOB;
+	}
+	jobCount = (CLUSTER_GRID_Z + slicesPerJob - 1) / slicesPerJob;
+	JobSystem::ParallelFor("Light cluster slices", CLUSTER_GRID_Z, slicesPerJob, [this](size_t first, size_t last)
+	{
+		AssignLights((int)first, (int)last - 1, &sliceOverflows[first]);
+	});
+
+	overflowCount = 0;
+	for (int slice = 0; slice < CLUSTER_GRID_Z; slice++) { overflowCount += sliceOverflows[slice]; }
+
+	//Compact per cluster slots into one list
+	lightIndices.clear();
+	maxClusterLightCount = 0;
+	for (int cluster = 0; cluster < CLUSTER_COUNT; cluster++)
+	{
+		unsigned int count = clusterLightCounts[cluster];
+		grid[cluster] = glm::uvec2((unsigned int)lightIndices.size(), count);
+		lightIndices.insert(lightIndices.end(), clusterLights.begin() + cluster * MAX_LIGHTS_PER_CLUSTER, clusterLights.begin() + cluster * MAX_LIGHTS_PER_CLUSTER + count);
+		maxClusterLightCount = glm::max(maxClusterLightCount, count);
+	}
+}
+
+void LightClusters::Upload(PointLight* pointLights, unsigned int pointLightCount, SpotLight* spotLights, unsigned int spotLightCount)
+{
+	//Light data, same order as assignment
+	lightData.clear();
+	for (unsigned int i = 0; i < pointLightCount + spotLightCount; i++)
+	{
+		bool spot = i >= pointLightCount;
+		PointLight* light = spot ? &spotLights[i - pointLightCount] : &pointLights[i];
+
+		glm::vec4 direction = glm::vec4(0.0f, 0.0f, 0.0f, -2.0f); //Edge below -1 marks point light
+		if (spot)
+		{
+			SpotLight* spotLight = (SpotLight*)light;
+			direction = glm::vec4(spotLight->GetDirection(), spotLight->GetProcEdge());
+		}
+
+		int shadowTile = light->IsShadowTileValid() ? light->GetShadowTile() : -1; //New tiles waiting for shadow budget hold no shadow map yet
+		lightData.push_back(glm::vec4(light->GetPosition(), (float)shadowTile));
+		lightData.push_back(glm::vec4(light->GetColor(), light->GetAmbientIntensity()));
+		lightData.push_back(glm::vec4(light->GetDiffuseIntensity(), light->GetConstant(), light->GetLinear(), light->GetExponent()));
+		lightData.push_back(direction);
+		lightData.push_back(glm::vec4((float)light->GetShadowFaceCount(), light->GetFarPlane(), light->HasPrefilteredShadows() ? 1.0f : 0.0f, 0.0f));
+	}
+
+	UploadBuffer(lightDataBuffer, lightData.empty() ? nullptr : &lightData[0], lightData.size() * sizeof(glm::vec4));
+	UploadBuffer(gridBuffer, &grid[0], grid.size() * sizeof(glm::uvec2));
+	UploadBuffer(indexBuffer, lightIndices.empty() ? nullptr : &lightIndices[0], lightIndices.size() * sizeof(uint16_t));
+}
+
+void LightClusters::Bind(Shader* shader)
+{
+	shader->BindSampler("s_lightData", LIGHT_DATA_TEXUNIT, lightDataTexture);
+	shader->BindSampler("s_clusterGrid", CLUSTER_GRID_TEXUNIT, gridTexture);
+	shader->BindSampler("s_clusterLightIndices", CLUSTER_LIGHT_INDEX_TEXUNIT, indexTexture);
+
+	//slice = log(depth) * scale + bias, same as GetSlice
+	float scale = CLUSTER_GRID_Z / logf(farPlane / nearPlane);
+	shader->SetUniform("u_clusterTileSize", (float)tileWidth, (float)tileHeight);
+	shader->SetUniform("u_clusterScale", scale);
+	shader->SetUniform("u_clusterBias", -logf(nearPlane) * scale);
+}
+
+LightClusters::~LightClusters()
+{
+	if (lightDataBuffer)
+	{
+		glDeleteBuffers(1, &lightDataBuffer);
+		GLState::ForgetBuffer(lightDataBuffer);
+		glDeleteTextures(1, &lightDataTexture);
+		GLState::ForgetTexture(lightDataTexture);
+	}
+	if (gridBuffer)
+	{
+		glDeleteBuffers(1, &gridBuffer);
+		GLState::ForgetBuffer(gridBuffer);
+		glDeleteTextures(1, &gridTexture);
+		GLState::ForgetTexture(gridTexture);
+	}
+	if (indexBuffer)
+	{
+		glDeleteBuffers(1, &indexBuffer);
+		GLState::ForgetBuffer(indexBuffer);
+		glDeleteTextures(1, &indexTexture);
+		GLState::ForgetTexture(indexTexture);
+	}
+}
@@ -0,0 +1,98 @@
+/*
+Clustered lighting
+
+View frustum is split into CLUSTER_GRID_X * CLUSTER_GRID_Y screen tiles and CLUSTER_GRID_Z depth slices. Slices are exponential
+(every slice ends the same fraction further than it starts), so near clusters are thin and far clusters are deep.
+Every frame point and spot lights are assigned on CPU to the clusters their volume touches, and fragment shader shades only lights of its cluster,
+so cost per fragment depends on how many lights overlap it instead of how many lights are in the scene.
+
+Assignment: light sphere of influence (view space) is tested against view space AABBs of clusters in depth slices it can reach,
+four boxes per iteration with SSE (Culling::CullBoxesBySphere). Spot lights are additionally tested as a cone against bounding sphere of the cluster.
+When there are many lights, slices are split between jobs (JobSystem::ParallelFor), each job writes only to clusters of its own slices.
+Assign touches no OpenGL and can run as a job itself (renderer runs it while shadow maps are drawn), Upload packs light data
+(shadow tiles are known only after shadow atlas allocation) and uploads everything on the thread with the context.
+
+GPU data (buffer textures, available in OpenGL 3.3 unlike SSBO):
+- light data (RGBA32F): LIGHT_DATA_TEXELS texels per light, point lights first, then spot lights
+- cluster grid (RG32UI): offset into light index list and light count for every cluster
+- light indices (R16UI): lights of all clusters, one cluster after another
+Cluster index = x + y * CLUSTER_GRID_X + z * CLUSTER_GRID_X * CLUSTER_GRID_Y, tile y = 0 is at the bottom of the screen (same as gl_FragCoord).
+*/
+
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+#include <GL\glew.h>
+#include <glm\glm.hpp>
+
+#include "CommonValues.h"
+#include "Camera.h"
+#include "Shader.h"
+#include "Culling.h"
+#include "Lighting/PointLight.h"
+#include "Lighting/SpotLight.h"
+
+class LightClusters
+{
+public:
+	LightClusters();
+
+	bool Init();
+
+	//Rebuild cluster bounds if projection changed and assign lights to clusters (CPU only, camera and light positions must not change meanwhile)
+	void Assign(Camera* camera, GLuint screenWidth, GLuint screenHeight, PointLight* pointLights, unsigned int pointLightCount, SpotLight* spotLights, unsigned int spotLightCount);
+	void Upload(PointLight* pointLights, unsigned int pointLightCount, SpotLight* spotLights, unsigned int spotLightCount); //Same lights as Assign, after it finished
+	void Bind(Shader* shader); //Bind buffer textures and set grid uniforms (shader has to be in use)
+
+	unsigned int GetLightCount() { return (unsigned int)lights.size(); }
+	unsigned int GetLightIndexCount() { return (unsigned int)lightIndices.size(); } //Sum of light counts of all clusters
+	unsigned int GetMaxClusterLightCount() { return maxClusterLightCount; }
+	unsigned int GetOverflowCount() { return overflowCount; } //Light assignments dropped because cluster was full
+	unsigned int GetJobCount() { return jobCount; } //Jobs used for last assignment
+
+	~LightClusters();
+
+private:
+	struct ClusterLight //Light in view space, prepared for assignment
+	{
+		glm::vec3 position;
+		float range;
+		glm::vec3 direction; //Spot lights only
+		float cosAngle, sinAngle; //Half angle of the cone, spot lights only
+		bool spot;
+	};
+
+	static const int CLUSTER_COUNT = CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z;
+	static const int CLUSTERS_PER_SLICE = CLUSTER_GRID_X * CLUSTER_GRID_Y;
+
+	GLuint lightDataBuffer, lightDataTexture;
+	GLuint gridBuffer, gridTexture;
+	GLuint indexBuffer, indexTexture;
+
+	//Cluster bounds (view space AABB, structure of arrays for SIMD)
+	float boundsMinX[CLUSTER_COUNT], boundsMinY[CLUSTER_COUNT], boundsMinZ[CLUSTER_COUNT];
+	float boundsMaxX[CLUSTER_COUNT], boundsMaxY[CLUSTER_COUNT], boundsMaxZ[CLUSTER_COUNT];
+	float fieldOfView, aspectRatio, nearPlane, farPlane; //Projection the bounds were built for
+	GLuint tileWidth, tileHeight; //In pixels
+
+	std::vector<ClusterLight> lights;
+	std::vector<glm::vec4> lightData;
+	std::vector<uint16_t> clusterLights; //MAX_LIGHTS_PER_CLUSTER slots per cluster, filled during assignment
+	unsigned int clusterLightCounts[CLUSTER_COUNT];
+	unsigned int sliceOverflows[CLUSTER_GRID_Z]; //Every assignment job counts into its first slice
+	std::vector<glm::uvec2> grid;
+	std::vector<uint16_t> lightIndices;
+
+	unsigned int maxClusterLightCount;
+	unsigned int overflowCount;
+	unsigned int jobCount;
+
+	void UpdateClusterBounds();
+	int GetSlice(float depth); //Depth slice containing view depth (can be outside of the grid)
+	void AssignLights(int firstSlice, int lastSlice, unsigned int* overflow); //Assign all lights to clusters in given range of slices
+	static bool ConeIntersectsSphere(const ClusterLight& light, const glm::vec3& center, float radius);
+	static void CreateBufferTexture(GLuint& buffer, GLuint& texture, GLenum format);
+	static void UploadBuffer(GLuint buffer, const void* data, size_t size);
+};
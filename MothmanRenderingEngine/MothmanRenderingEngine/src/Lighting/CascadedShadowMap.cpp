@@ -0,0 +1,49 @@
+#include "CascadedShadowMap.h"
+
+#include "..\GLState.h"
+
+CascadedShadowMap::CascadedShadowMap() : ShadowMap() {}
+
+bool CascadedShadowMap::Init(unsigned int width, unsigned int height)
+{
+	shadowWidth = width;
+	shadowHeight = height;
+
+	glGenFramebuffers(1, &FBO);
+
+	glGenTextures(1, &shadowMap);
+	GLState::BindTexture(GL_TEXTURE_2D_ARRAY, shadowMap);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT, width, height, MAX_SHADOW_CASCADES, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr); //One layer per cascade
+
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+	float bColour[] = { 1.0f, 1.0f, 1.0f, 1.0f }; //No shadows outside of cascade
+	glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, bColour);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	GLState::BindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
+	glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, shadowMap, 0, 0); //First cascade, others are attached when rendering (AttachCascade)
+
+	glDrawBuffer(GL_NONE); //Draw scene (only depth)
+	glReadBuffer(GL_NONE);
+
+	GLenum Status = glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER);
+	if (Status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		printf("Framebuffer error: %i\n", Status);
+		return false;
+	}
+
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+	return true;
+}
+
+void CascadedShadowMap::AttachCascade(int cascade)
+{
+	glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, shadowMap, 0, cascade);
+}
+
+CascadedShadowMap::~CascadedShadowMap()
+{
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include "ShadowMap.h"
+#include "../CommonValues.h"
+
+class CascadedShadowMap :
+	public ShadowMap
+{
+public:
+	CascadedShadowMap();
+
+	bool Init(unsigned int width, unsigned int height); //Depth texture array with MAX_SHADOW_CASCADES layers
+
+	void AttachCascade(int cascade); //Render into one layer of the array (FBO has to be bound)
+
+	~CascadedShadowMap();
+};
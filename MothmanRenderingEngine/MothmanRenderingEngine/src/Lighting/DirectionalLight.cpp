@@ -3,6 +3,12 @@
 DirectionalLight::DirectionalLight() : Light()
 {
 	direction = glm::vec3(0.0f, -1.0f, 0.0f);
+
+	cascadeCount = 3;
+	splitLambda = 0.75f;
+	shadowDistance = 100.0f;
+	casterDistance = 50.0f;
+	for (int i = 0; i < MAX_SHADOW_CASCADES; i++) { cascadeSplits[i] = 0.0f; }
 }
 
 DirectionalLight::DirectionalLight(GLuint shadowWidth, GLuint shadowHeight, 
@@ -11,12 +17,91 @@ DirectionalLight::DirectionalLight(GLuint shadowWidth, GLuint shadowHeight,
 	GLfloat xDir, GLfloat yDir, GLfloat zDir) : Light(shadowWidth, shadowHeight, red, green, blue, aIntensity, dIntensity)
 {
 	direction = glm::vec3(xDir, yDir, zDir);
-	lightProj = glm::ortho(-20.0f, 20.0f, -20.0f, 20.0f, 0.1f, 100.0f); //Orthographic box (beyond far plane shadows will not be drawn)
+
+	cascadeCount = 3;
+	splitLambda = 0.75f;
+	shadowDistance = 100.0f;
+	casterDistance = 50.0f;
+	for (int i = 0; i < MAX_SHADOW_CASCADES; i++) { cascadeSplits[i] = 0.0f; }
+
+	shadowMap = new CascadedShadowMap();
+	shadowMap->Init(shadowWidth, shadowHeight);
+}
+
+void DirectionalLight::SetCascadeCount(int value)
+{
+	cascadeCount = glm::clamp(value, 1, MAX_SHADOW_CASCADES);
+	shadowMapDirty = true;
+}
+
+void DirectionalLight::SetShadowResolution(GLuint size)
+{
+	if (shadowMap == nullptr || size == shadowMap->GetShadowWidth())
+	{
+		return;
+	}
+
+	delete GetCascadedShadowMap();
+	shadowMap = new CascadedShadowMap();
+	shadowMap->Init(size, size);
+	shadowMapDirty = true; //Old cascades are gone
 }
 
-glm::mat4 DirectionalLight::CalculateLightTransform() //Return view matrix from light source point of view
+void DirectionalLight::UpdateCascades(Camera* camera)
 {
-	return lightProj * glm::lookAt(-direction, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	glm::vec3 lightDirection = glm::normalize(direction);
+	glm::vec3 up = glm::abs(lightDirection.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+	glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), lightDirection, up); //Only rotation, cascades are positioned by their projections so texel grid stays fixed in world
+
+	float nearPlane = camera->GetNearPlane();
+	float farPlane = glm::min(camera->GetFarPlane(), shadowDistance);
+	glm::mat4 inverseCameraView = glm::inverse(camera->GetViewMatrix());
+
+	float splitNear = nearPlane;
+	for (int i = 0; i < cascadeCount; i++)
+	{
+		//Practical split scheme
+		float p = (float)(i + 1) / (float)cascadeCount;
+		float logSplit = nearPlane * powf(farPlane / nearPlane, p);
+		float uniformSplit = nearPlane + (farPlane - nearPlane) * p;
+		float splitFar = splitLambda * logSplit + (1.0f - splitLambda) * uniformSplit;
+
+		//Corners of the sub-frustum in world space
+		glm::mat4 inverseProjection = inverseCameraView * glm::inverse(glm::perspective(glm::radians(camera->GetFOV()), camera->GetAspectRatio(), splitNear, splitFar));
+		glm::vec3 corners[8];
+		glm::vec3 center = glm::vec3(0.0f, 0.0f, 0.0f);
+		for (int c = 0; c < 8; c++)
+		{
+			glm::vec4 corner = inverseProjection * glm::vec4((c & 1) ? 1.0f : -1.0f, (c & 2) ? 1.0f : -1.0f, (c & 4) ? 1.0f : -1.0f, 1.0f);
+			corners[c] = glm::vec3(corner) / corner.w;
+			center += corners[c];
+		}
+		center /= 8.0f;
+
+		//Bounding sphere does not change size with camera rotation, radius is rounded to avoid flickering caused by float precision
+		float radius = 0.0f;
+		for (int c = 0; c < 8; c++)
+		{
+			radius = glm::max(radius, glm::length(corners[c] - center));
+		}
+		radius = ceilf(radius * 16.0f) / 16.0f;
+
+		//Snap center to texel grid in light space
+		glm::vec3 lightSpaceCenter = glm::vec3(lightView * glm::vec4(center, 1.0f));
+		float texelSize = (2.0f * radius) / (float)shadowMap->GetShadowWidth();
+		lightSpaceCenter.x = floorf(lightSpaceCenter.x / texelSize) * texelSize;
+		lightSpaceCenter.y = floorf(lightSpaceCenter.y / texelSize) * texelSize;
+
+		glm::mat4 lightProjection = glm::ortho(lightSpaceCenter.x - radius, lightSpaceCenter.x + radius,
+			lightSpaceCenter.y - radius, lightSpaceCenter.y + radius,
+			-lightSpaceCenter.z - radius - casterDistance, -lightSpaceCenter.z + radius); //Light looks down -z, so near and far are negated depths
+
+		cascadeTransforms[i] = lightProjection * lightView;
+		cascadeFrusta[i].ExtractPlanes(cascadeTransforms[i]);
+		cascadeSplits[i] = splitFar;
+
+		splitNear = splitFar;
+	}
 }
 
 DirectionalLight::~DirectionalLight()
@@ -1,6 +1,21 @@
+/*
+Directional light with cascaded shadow maps
+
+Camera frustum (up to shadowDistance) is split into cascades using practical split scheme (blend of logarithmic and uniform splits, splitLambda).
+Each cascade is fitted with a bounding sphere of its sub-frustum, so size of its orthographic projection does not change when camera rotates,
+and the projection is snapped to shadow map texels, so shadows do not shimmer when camera moves.
+Depth range is extended towards the light by casterDistance so that casters outside of the sub-frustum still cast shadows into it.
+
+All cascades are stored in one depth texture array (CascadedShadowMap), fragment shader selects cascade by view depth.
+*/
+
 #pragma once
 #include "Light.h"
+#include "CascadedShadowMap.h"
 #include "../Shader.h"
+#include "../Frustum.h"
+#include "../Camera.h"
+#include "../CommonValues.h"
 
 class DirectionalLight :
 	public Light
@@ -13,10 +28,38 @@ public:
 		GLfloat xDir, GLfloat yDir, GLfloat zDir);
 
 	glm::vec3 GetDirection() { return direction; }
-	glm::mat4 CalculateLightTransform();
+
+	void UpdateCascades(Camera* camera); //Fit cascades to the camera frustum, call after camera matrices are calculated
+
+	int GetCascadeCount() { return cascadeCount; }
+	void SetCascadeCount(int value);
+	GLfloat GetSplitLambda() { return splitLambda; }
+	void SetSplitLambda(GLfloat value) { splitLambda = value; }
+	GLfloat GetShadowDistance() { return shadowDistance; }
+	void SetShadowDistance(GLfloat value) { shadowDistance = value; }
+
+	const glm::mat4& GetCascadeTransform(int cascade) { return cascadeTransforms[cascade]; } //Projection * view of the cascade
+	const Frustum& GetCascadeFrustum(int cascade) { return cascadeFrusta[cascade]; }
+	GLfloat GetCascadeSplit(int cascade) { return cascadeSplits[cascade]; } //View space distance where cascade ends
+
+	bool IsCascadeMoved(int cascade) { return cascadeTransforms[cascade] != renderedCascadeTransforms[cascade]; } //Cascade projection changed since it was last rendered
+	void SetCascadeRendered(int cascade) { renderedCascadeTransforms[cascade] = cascadeTransforms[cascade]; }
+
+	CascadedShadowMap* GetCascadedShadowMap() { return (CascadedShadowMap*)shadowMap; }
+	void SetShadowResolution(GLuint size); //Recreate shadow map with new width and height, all cascades are rendered again
+
 	~DirectionalLight();
 
 private:
 	glm::vec3 direction;
-};
 
+	int cascadeCount;
+	GLfloat splitLambda; //0 - uniform splits, 1 - logarithmic splits
+	GLfloat shadowDistance; //Shadows are not rendered further from the camera than this
+	GLfloat casterDistance; //How far towards the light casters are included
+
+	glm::mat4 cascadeTransforms[MAX_SHADOW_CASCADES];
+	glm::mat4 renderedCascadeTransforms[MAX_SHADOW_CASCADES];
+	Frustum cascadeFrusta[MAX_SHADOW_CASCADES];
+	GLfloat cascadeSplits[MAX_SHADOW_CASCADES];
+};
@@ -6,16 +6,18 @@ Light::Light()
 	color = glm::vec3(1.0f, 1.0f, 1.0f); //Light do not color the object, it just show color parts of the object, pure white light color - all colors in 100% intensity will be shown
 	ambientIntensity = 1.0f;
 	diffuseIntensity = 0.0f;
+	shadowMap = nullptr;
+	shadowMapDirty = true;
 }
 
 Light::Light(GLuint shadowWidth, GLuint shadowHeight, GLfloat red, GLfloat green, GLfloat blue, GLfloat aIntensity, GLfloat dIntensity)
 {
-	shadowMap = new ShadowMap();
-	shadowMap->Init(shadowWidth, shadowHeight);
+	shadowMap = nullptr; //Each light type creates its own kind of shadow map
 
 	color = glm::vec3(red, green, blue);
 	ambientIntensity = aIntensity;
 	diffuseIntensity = dIntensity;
+	shadowMapDirty = true;
 }
 
 Light::~Light()
@@ -23,6 +23,9 @@ public:
 	GLfloat GetDiffuseIntensity() { return diffuseIntensity; }
 	void SetDiffuseIntensity(GLfloat value) { diffuseIntensity = value; }
 
+	bool IsShadowMapDirty() { return shadowMapDirty; } //Light changed in a way that invalidates whole shadow map
+	void SetShadowMapDirty(bool value) { shadowMapDirty = value; }
+
 	~Light();
 
 protected:
@@ -32,5 +35,6 @@ protected:
 
 	glm::mat4 lightProj; //View matrix from light persepective
 	ShadowMap* shadowMap;
+	bool shadowMapDirty;
 };
 
@@ -6,6 +6,21 @@ PointLight::PointLight() : Light()
 	constant = 1.0f;
 	linear = 0.0f;
 	exponent = 0.0f;
+	nearPlane = 0.1f;
+	farPlane = 100.0f;
+
+	lightTransformsDirty = true;
+	faceFrustaRange = -1.0f;
+
+	shadowMode = POINT_SHADOW_CUBE;
+	maxShadowTileSize = MAX_SHADOW_TILE_SIZE;
+	shadowTile = -1;
+	shadowTileSize = 0;
+	shadowTileCount = 0;
+	shadowTileValid = false;
+	shadowAge = 0;
+	prefilteredShadows = false;
+	for (int i = 0; i < 6; i++) { faceEmpty[i] = false; }
 }
 
 PointLight::PointLight(GLfloat shadowWidth, GLfloat shadowHeight,
@@ -20,25 +35,178 @@ PointLight::PointLight(GLfloat shadowWidth, GLfloat shadowHeight,
 	linear = lin;
 	exponent = exp;
 
-	float aspect = (float)shadowWidth / (float)shadowHeight;
+	nearPlane = near;
 	farPlane = far;
-	lightProj = glm::perspective(glm::radians(90.0f), aspect, near, far); //Projection matrix from light source
-	shadowMap = new OmniShadowMap();
-	shadowMap->Init(shadowWidth, shadowHeight); //Initialize shadow map
 
+	lightTransformsDirty = true;
+	faceFrustaRange = -1.0f;
+
+	shadowMode = POINT_SHADOW_CUBE;
+	maxShadowTileSize = glm::min((GLuint)shadowWidth, (GLuint)MAX_SHADOW_TILE_SIZE); //Shadow resolution is the largest tile this light can get in the atlas
+	shadowTile = -1;
+	shadowTileSize = 0;
+	shadowTileCount = 0;
+	shadowTileValid = false;
+	shadowAge = 0;
+	prefilteredShadows = false;
+	for (int i = 0; i < 6; i++) { faceEmpty[i] = false; }
+}
+
+void PointLight::SetPosition(glm::vec3 newPosition)
+{
+	if (newPosition != position)
+	{
+		lightTransformsDirty = true;
+		shadowMapDirty = true;
+	}
+	position = newPosition;
+}
+
+void PointLight::SetShadowMode(PointShadowMode mode)
+{
+	if (mode != shadowMode)
+	{
+		lightTransformsDirty = true;
+		shadowMapDirty = true;
+		shadowTileValid = false;
+		for (int i = 0; i < 6; i++) { faceEmpty[i] = false; }
+	}
+	shadowMode = mode;
+}
+
+void PointLight::SetPrefilteredShadows(bool value)
+{
+	if (value != prefilteredShadows) //Moments of all faces have to be generated
+	{
+		shadowMapDirty = true;
+		for (int i = 0; i < 6; i++) { faceEmpty[i] = false; }
+	}
+	prefilteredShadows = value;
+}
+
+void PointLight::UpdateLightTransforms() //Calculate light transform for each direction
+{
+	static const glm::vec3 faceDirections[6] = { glm::vec3(1.0, 0.0, 0.0), glm::vec3(-1.0, 0.0, 0.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(0.0, -1.0, 0.0), glm::vec3(0.0, 0.0, 1.0), glm::vec3(0.0, 0.0, -1.0) };
+	static const glm::vec3 faceUps[6] = { glm::vec3(0.0, -1.0, 0.0), glm::vec3(0.0, -1.0, 0.0), glm::vec3(0.0, 0.0, 1.0), glm::vec3(0.0, 0.0, -1.0), glm::vec3(0.0, -1.0, 0.0), glm::vec3(0.0, -1.0, 0.0) };
+
+	if (shadowMode == POINT_SHADOW_DUAL_PARABOLOID)
+	{
+		for (int i = 0; i < 2; i++) //Hemispheres face the same way as +Y and -Y cube faces
+		{
+			faceViews[i] = glm::lookAt(position, position + faceDirections[i + 2], faceUps[i + 2]);
+			lightTransforms[i] = faceViews[i]; //Paraboloid projection is not linear, vertex shader does it
+		}
+	}
+	else
+	{
+		for (int i = 0; i < 6; i++)
+		{
+			faceViews[i] = glm::lookAt(position, position + faceDirections[i], faceUps[i]);
+			lightTransforms[i] = GetShadowProjection(farPlane) * faceViews[i];
+		}
+	}
+
+	lightTransformsDirty = false;
+	faceFrustaRange = -1.0f; //Frusta depend on transforms
+}
+
+void PointLight::UpdateFaceFrusta()
+{
+	if (lightTransformsDirty) { UpdateLightTransforms(); }
+
+	GLfloat range = GetRange();
+	if (range == faceFrustaRange) { return; }
+
+	//Culling frustum ends at range instead of far plane, so it is also a test against sphere of influence (conservative at the corners)
+	glm::mat4 rangeProjection = GetShadowProjection(glm::max(range, nearPlane * 2.0f));
+	for (int i = 0; i < GetShadowFaceCount(); i++)
+	{
+		faceFrusta[i].ExtractPlanes(rangeProjection * faceViews[i]);
+	}
+	faceFrustaRange = range;
+	shadowMapDirty = true; //Casters that are drawn depend on range
 }
 
-std::vector<glm::mat4> PointLight::CalculateLightTransform() //Calculate light transform for each direction
+glm::mat4 PointLight::GetShadowProjection(GLfloat far)
 {
-	std::vector<glm::mat4> lightTransforms;
-	lightTransforms.push_back(lightProj *glm::lookAt(position, position + glm::vec3(1.0, 0.0, 0.0), glm::vec3(0.0, -1.0, 0.0)));
-	lightTransforms.push_back(lightProj *glm::lookAt(position, position + glm::vec3(-1.0, 0.0, 0.0), glm::vec3(0.0, -1.0, 0.0)));
-	lightTransforms.push_back(lightProj *glm::lookAt(position, position + glm::vec3(0.0, 1.0, 0.0), glm::vec3(0.0, 0.0, 1.0)));
-	lightTransforms.push_back(lightProj *glm::lookAt(position, position + glm::vec3(0.0, -1.0, 0.0), glm::vec3(0.0, 0.0, -1.0)));
-	lightTransforms.push_back(lightProj *glm::lookAt(position, position + glm::vec3(0.0, 0.0, 1.0), glm::vec3(0.0, -1.0, 0.0)));
-	lightTransforms.push_back(lightProj *glm::lookAt(position, position + glm::vec3(0.0, 0.0, -1.0), glm::vec3(0.0, -1.0, 0.0)));
+	if (shadowMode == POINT_SHADOW_DUAL_PARABOLOID)
+	{
+		return glm::ortho(-far, far, -far, far, 0.0f, far); //Box around the hemisphere, only used for culling
+	}
+	return glm::perspective(glm::radians(90.0f), 1.0f, nearPlane, far);
+}
+
+const glm::mat4& PointLight::GetLightTransform(int face)
+{
+	if (lightTransformsDirty) { UpdateLightTransforms(); }
+	return lightTransforms[face];
+}
+
+const Frustum& PointLight::GetFaceFrustum(int face)
+{
+	UpdateFaceFrusta();
+	return faceFrusta[face];
+}
+
+GLuint PointLight::CalculateShadowTileSize(const glm::vec3& cameraPosition, float cameraFOV)
+{
+	GLfloat range = GetRange();
+	if (range <= 0.0f) { return 0; } //Light does not reach anything
+
+	//Part of the screen height covered by sphere of influence (whole screen when camera is inside of it)
+	float distance = glm::length(cameraPosition - position);
+	float coverage = 1.0f;
+	if (distance > range)
+	{
+		coverage = glm::clamp(range / (distance * tanf(glm::radians(cameraFOV) * 0.5f)), 0.0f, 1.0f);
+	}
+
+	GLuint size = MIN_SHADOW_TILE_SIZE;
+	while (size < maxShadowTileSize && size < coverage * maxShadowTileSize) { size *= 2; } //Round up to power of two
+	return size;
+}
+
+void PointLight::SetShadowTiles(int firstTile, GLuint tileSize)
+{
+	if (firstTile != shadowTile || tileSize != shadowTileSize) //Moved to other place in the atlas, previous content is lost
+	{
+		shadowMapDirty = true;
+		shadowTileValid = false;
+		for (int i = 0; i < 6; i++) { faceEmpty[i] = false; }
+	}
+	shadowTile = firstTile;
+	shadowTileSize = tileSize;
+	shadowTileCount = firstTile >= 0 ? GetShadowFaceCount() : 0;
+}
+
+float PointLight::CalculateShadowImportance(const glm::vec3& cameraPosition)
+{
+	float coverage = (float)shadowTileSize / MAX_SHADOW_TILE_SIZE; //Tile size already follows screen coverage
+	float intensity = glm::max(color.r, glm::max(color.g, color.b)) * (ambientIntensity + diffuseIntensity);
+	float range = GetRange();
+	float proximity = range / (range + glm::length(cameraPosition - position)); //1 when camera is at the light, 0.5 at the edge of its range
+
+	return (coverage + proximity) * intensity * (1.0f + shadowAge); //Age makes every waiting light win eventually
+}
+
+GLfloat PointLight::GetRange()
+{
+	//Distance at which attenuated light (color / (exponent * d^2 + linear * d + constant)) drops below one step of 8 bit color
+	GLfloat intensity = glm::max(color.r, glm::max(color.g, color.b)) * (ambientIntensity + diffuseIntensity);
+	GLfloat limit = intensity * 256.0f;
+	if (limit <= constant) { return 0.0f; } //Too dim to be visible even at the light position
+
+	GLfloat range = farPlane;
+	if (exponent > 0.0f)
+	{
+		range = (-linear + sqrtf(linear * linear - 4.0f * exponent * (constant - limit))) / (2.0f * exponent);
+	}
+	else if (linear > 0.0f)
+	{
+		range = (limit - constant) / linear;
+	}
 
-	return lightTransforms;
+	return glm::clamp(range, 0.0f, farPlane); //Shadow map does not reach further than far plane anyway
 }
 
 PointLight::~PointLight()
@@ -1,8 +1,15 @@
 #pragma once
 #include "Light.h"
-#include "OmniShadowMap.h"
+#include "../Frustum.h"
+#include "../CommonValues.h"
 #include <vector>
 
+enum PointShadowMode
+{
+	POINT_SHADOW_CUBE, //Six perspective faces
+	POINT_SHADOW_DUAL_PARABOLOID, //Two hemispheres (+Y and -Y), warped in vertex shader, cheaper but less precise
+};
+
 class PointLight : public Light
 {
 public:
@@ -14,11 +21,32 @@ public:
 		GLfloat xPos, GLfloat yPos, GLfloat zPos,
 		GLfloat con, GLfloat lin, GLfloat exp);
 
-	std::vector<glm::mat4> CalculateLightTransform();
+	virtual int GetShadowFaceCount() { return shadowMode == POINT_SHADOW_DUAL_PARABOLOID ? 2 : 6; } //Shadow tiles needed by the light, one per face
+	PointShadowMode GetShadowMode() { return shadowMode; }
+	void SetShadowMode(PointShadowMode mode); //Marks shadow map dirty when mode changes
+	const glm::mat4& GetLightTransform(int face); //Projection * view for one cube map face (only view for paraboloid face), cached until light moves
+	const Frustum& GetFaceFrustum(int face); //Volume of one cube map face limited by range of the light
+	void UpdateFaceFrusta(); //Rebuild face frusta if light moved or its range changed (marks shadow map dirty)
 	glm::vec3 GetPosition() { return position; }
-	void SetPosition(glm::vec3 newPosition) { position = newPosition; }
+	void SetPosition(glm::vec3 newPosition);
+
+	GLuint CalculateShadowTileSize(const glm::vec3& cameraPosition, float cameraFOV); //Atlas tile size for each face based on screen coverage, 0 when light needs no shadows
+	void SetShadowTiles(int firstTile, GLuint tileSize); //Tiles in the shadow atlas, kept across frames while size fits (-1 - no tiles)
+	int GetShadowTile() { return shadowTile; }
+	GLuint GetShadowTileSize() { return shadowTileSize; }
+	int GetShadowTileCount() { return shadowTileCount; } //Face count of the mode the tiles were allocated for
+	bool IsShadowTileValid() { return shadowTileValid; } //False when tiles moved in the atlas or mode changed, old content cannot be shown
+	void SetShadowTileValid(bool value) { shadowTileValid = value; }
+	float CalculateShadowImportance(const glm::vec3& cameraPosition); //Higher - shadow update is more urgent (grows with time since last update)
+	unsigned int GetShadowAge() { return shadowAge; } //Frames since shadow was last rendered while it needed update
+	void SetShadowAge(unsigned int value) { shadowAge = value; }
+	bool HasPrefilteredShadows() { return prefilteredShadows; } //EVSM moments are generated after rendering and sampled instead of PCF
+	void SetPrefilteredShadows(bool value);
+	bool IsFaceEmpty(int face) { return faceEmpty[face]; }
+	void SetFaceEmpty(int face, bool value) { faceEmpty[face] = value; }
 
 	GLfloat GetFarPlane() { return farPlane; }
+	GLfloat GetRange(); //Radius of sphere of influence, nothing outside of it is lit or shadowed by this light
 	GLfloat GetConstant() { return constant; }
 	GLfloat GetLinear() { return linear; }
 	GLfloat GetExponent() { return exponent; }
@@ -29,6 +57,25 @@ protected:
 	glm::vec3 position;
 
 	GLfloat constant, linear, exponent;
-	GLfloat farPlane;
+	GLfloat nearPlane, farPlane;
+
+	PointShadowMode shadowMode;
+	GLuint maxShadowTileSize;
+	int shadowTile; //First of GetShadowFaceCount() tiles (one per face) in the shadow atlas
+	GLuint shadowTileSize;
+	int shadowTileCount;
+	bool shadowTileValid;
+	bool prefilteredShadows;
+	unsigned int shadowAge;
+	bool faceEmpty[6]; //Face tile was cleared and nothing was drawn into it, so it can be skipped while it stays empty
+
+	virtual void UpdateLightTransforms();
+	virtual glm::mat4 GetShadowProjection(GLfloat far); //Projection of one shadow face ending at far
+
+	glm::mat4 faceViews[6];
+	glm::mat4 lightTransforms[6];
+	Frustum faceFrusta[6];
+	bool lightTransformsDirty; //Set when light moves
+	GLfloat faceFrustaRange; //Range used for current face frusta, they are rebuilt when it changes (intensity or attenuation changed)
 };
 
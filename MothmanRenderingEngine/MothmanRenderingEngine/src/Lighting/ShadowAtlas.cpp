@@ -0,0 +1,251 @@
+#include "ShadowAtlas.h"
+
+#include "..\RenderStats.h"
+#include "..\GLState.h"
+
+ShadowAtlas::ShadowAtlas()
+{
+	FBO = 0;
+	atlasTexture = 0;
+	UBO = 0;
+	atlasSize = 0;
+	momentsFBO = 0;
+	momentsTexture = 0;
+	blurFBO = 0;
+	blurTexture = 0;
+	blurSize = 0;
+	tileCount = 0;
+	usedArea = 0;
+	for (int i = 0; i < MAX_SHADOW_TILES; i++)
+	{
+		tileFirstCell[i] = 0;
+		tileUsed[i] = false;
+	}
+}
+
+bool ShadowAtlas::Init(unsigned int size)
+{
+	atlasSize = size;
+	unsigned int cellsPerSide = atlasSize / MIN_SHADOW_TILE_SIZE;
+	cellUsed.assign(cellsPerSide * cellsPerSide, false);
+
+	glGenFramebuffers(1, &FBO);
+
+	glGenTextures(1, &atlasTexture);
+	GLState::BindTexture(GL_TEXTURE_2D, atlasTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, atlasSize, atlasSize, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	GLState::BindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
+	glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, atlasTexture, 0);
+
+	glDrawBuffer(GL_NONE); //Draw scene (only depth)
+	glReadBuffer(GL_NONE);
+
+	GLenum Status = glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER);
+	if (Status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		printf("Framebuffer error: %i\n", Status);
+		return false;
+	}
+
+	glClear(GL_DEPTH_BUFFER_BIT); //Tiles that are not rendered yet are empty
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	glGenBuffers(1, &UBO);
+	GLState::BindBuffer(GL_UNIFORM_BUFFER, UBO);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(TileBlock), nullptr, GL_DYNAMIC_DRAW);
+	GLState::BindBuffer(GL_UNIFORM_BUFFER, 0); //Not bound to the block binding here, scene pass command list binds it
+
+	blurSize = MAX_SHADOW_TILE_SIZE / SHADOW_MOMENTS_SCALE;
+	if (!CreateColorTarget(momentsFBO, momentsTexture, atlasSize / SHADOW_MOMENTS_SCALE)) { return false; }
+	if (!CreateColorTarget(blurFBO, blurTexture, blurSize)) { return false; }
+
+	return true;
+}
+
+bool ShadowAtlas::CreateColorTarget(GLuint& framebuffer, GLuint& texture, unsigned int size)
+{
+	glGenFramebuffers(1, &framebuffer);
+
+	glGenTextures(1, &texture);
+	GLState::BindTexture(GL_TEXTURE_2D, texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, size, size, 0, GL_RGBA, GL_FLOAT, nullptr);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR); //Moments can be filtered
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+
+	GLenum Status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	if (Status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		printf("Framebuffer error: %i\n", Status);
+		return false;
+	}
+
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+	return true;
+}
+
+void ShadowAtlas::Clear()
+{
+	tileCount = 0;
+	usedArea = 0;
+	for (int i = 0; i < MAX_SHADOW_TILES; i++) { tileUsed[i] = false; }
+	cellUsed.assign(cellUsed.size(), false);
+}
+
+void ShadowAtlas::MarkTileUsed(int tile)
+{
+	unsigned int cellSize = tileRects[tile].z / MIN_SHADOW_TILE_SIZE;
+	for (unsigned int cell = 0; cell < cellSize * cellSize; cell++)
+	{
+		cellUsed[tileFirstCell[tile] + cell] = true;
+	}
+	tileUsed[tile] = true;
+	tileCount++;
+	usedArea += tileRects[tile].z * tileRects[tile].w;
+}
+
+void ShadowAtlas::Keep(int firstTile, unsigned int count)
+{
+	for (unsigned int i = 0; i < count; i++)
+	{
+		if (!tileUsed[firstTile + i]) { MarkTileUsed(firstTile + i); }
+	}
+}
+
+bool ShadowAtlas::IsBlockFree(unsigned int firstCell, unsigned int cellCount)
+{
+	for (unsigned int cell = firstCell; cell < firstCell + cellCount; cell++)
+	{
+		if (cellUsed[cell]) { return false; }
+	}
+	return true;
+}
+
+unsigned int ShadowAtlas::DecodeMorton(unsigned int code)
+{
+	code &= 0x55555555;
+	code = (code ^ (code >> 1)) & 0x33333333;
+	code = (code ^ (code >> 2)) & 0x0F0F0F0F;
+	code = (code ^ (code >> 4)) & 0x00FF00FF;
+	code = (code ^ (code >> 8)) & 0x0000FFFF;
+	return code;
+}
+
+int ShadowAtlas::Allocate(unsigned int tileSize, unsigned int count)
+{
+	//Consecutive free tile numbers, so shaders find face tiles as first tile + face
+	int firstTile = -1;
+	for (unsigned int tile = 0; tile + count <= MAX_SHADOW_TILES && firstTile < 0; tile++)
+	{
+		unsigned int free = 0;
+		while (free < count && !tileUsed[tile + free]) { free++; }
+		if (free == count) { firstTile = tile; }
+		else { tile += free; } //Skip the used tile too
+	}
+	if (firstTile < 0 || count > 6) { return -1; }
+
+	//First free aligned blocks, faces don't have to be next to each other in the atlas
+	unsigned int cellsPerTile = (tileSize / MIN_SHADOW_TILE_SIZE) * (tileSize / MIN_SHADOW_TILE_SIZE);
+	unsigned int blockCount = (unsigned int)cellUsed.size() / cellsPerTile;
+	unsigned int found = 0;
+	unsigned int blocks[6]; //Faces of one light
+	for (unsigned int block = 0; block < blockCount && found < count; block++)
+	{
+		if (IsBlockFree(block * cellsPerTile, cellsPerTile)) { blocks[found++] = block; }
+	}
+	if (found < count) { return -1; }
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		glm::uvec4 rect = glm::uvec4(DecodeMorton(blocks[i]) * tileSize, DecodeMorton(blocks[i] >> 1) * tileSize, tileSize, tileSize);
+		tileRects[firstTile + i] = rect;
+		tileBlock.rects[firstTile + i] = glm::vec4(rect) / (float)atlasSize;
+		tileFirstCell[firstTile + i] = blocks[i] * cellsPerTile;
+		MarkTileUsed(firstTile + i);
+	}
+	return firstTile;
+}
+
+void ShadowAtlas::SetTileMatrix(int tile, const glm::mat4& lightTransform)
+{
+	tileBlock.matrices[tile] = lightTransform;
+}
+
+void ShadowAtlas::UploadTiles()
+{
+	GLState::BindBuffer(GL_UNIFORM_BUFFER, UBO);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(TileBlock), &tileBlock);
+	RenderStats::Add(RENDER_STAT_BUFFER_UPLOAD_BYTES, sizeof(TileBlock));
+	GLState::BindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void ShadowAtlas::BindTile(int tile)
+{
+	glm::uvec4 rect = tileRects[tile];
+	GLState::Viewport(rect.x, rect.y, rect.z, rect.w);
+	GLState::Scissor(rect.x, rect.y, rect.z, rect.w); //Clear only this tile, others keep their cached shadows
+}
+
+void ShadowAtlas::BindMomentsTile(int tile)
+{
+	glm::uvec4 rect = tileRects[tile] / (unsigned int)SHADOW_MOMENTS_SCALE;
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, momentsFBO);
+	GLState::Viewport(rect.x, rect.y, rect.z, rect.w);
+}
+
+void ShadowAtlas::BindBlurTarget(int tile)
+{
+	glm::uvec4 rect = tileRects[tile] / (unsigned int)SHADOW_MOMENTS_SCALE;
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, blurFBO);
+	GLState::Viewport(0, 0, rect.z, rect.w);
+}
+
+glm::vec4 ShadowAtlas::GetBlurRect(int tile)
+{
+	glm::uvec4 rect = tileRects[tile] / (unsigned int)SHADOW_MOMENTS_SCALE;
+	return glm::vec4(0.0f, 0.0f, (float)rect.z / blurSize, (float)rect.w / blurSize);
+}
+
+ShadowAtlas::~ShadowAtlas()
+{
+	if (FBO)
+	{
+		glDeleteFramebuffers(1, &FBO);
+		GLState::ForgetFramebuffer(FBO);
+	}
+	if (atlasTexture)
+	{
+		glDeleteTextures(1, &atlasTexture);
+		GLState::ForgetTexture(atlasTexture);
+	}
+	if (UBO)
+	{
+		glDeleteBuffers(1, &UBO);
+		GLState::ForgetBuffer(UBO);
+	}
+	if (momentsFBO)
+	{
+		glDeleteFramebuffers(1, &momentsFBO);
+		GLState::ForgetFramebuffer(momentsFBO);
+		glDeleteTextures(1, &momentsTexture);
+		GLState::ForgetTexture(momentsTexture);
+	}
+	if (blurFBO)
+	{
+		glDeleteFramebuffers(1, &blurFBO);
+		GLState::ForgetFramebuffer(blurFBO);
+		glDeleteTextures(1, &blurTexture);
+		GLState::ForgetTexture(blurTexture);
+	}
+}
@@ -0,0 +1,88 @@
+/*
+Shadow atlas
+
+One depth texture shared by shadows of all point and spot lights. Each light gets one or more square tiles (for example 6 for cube shadows)
+with size based on how much of the screen the light can affect.
+
+Allocation: tiles have power of two sizes and are placed along Z-order (Morton) curve of the atlas, so a tile of size*size texels is an aligned
+run of MIN_SHADOW_TILE_SIZE cells in Morton order. Occupancy of cells and tile numbers is tracked, allocation takes the first free aligned block.
+Tiles stay in place across frames (their content is cached shadow map): every frame Clear frees everything, Keep takes back tiles of lights
+that didn't change, then lights that changed are allocated into what is left (largest first).
+
+Rects and light matrices of all tiles are uploaded to a uniform block (ShadowTiles), so shaders can index the atlas with a tile number.
+
+Prefiltered shadows: lights can also keep EVSM moments of their tiles in a second, smaller RGBA16F atlas with the same layout in uv.
+After depth of a tile is rendered, it is converted to moments and blurred horizontally into the blur texture, then blurred vertically
+into the moments atlas. Shading then needs one bilinear fetch instead of many PCF taps.
+*/
+
+#pragma once
+
+#include <stdio.h>
+#include <vector>
+#include <GL\glew.h>
+#include <glm\glm.hpp>
+
+#include "../CommonValues.h"
+
+class ShadowAtlas
+{
+public:
+	ShadowAtlas();
+
+	bool Init(unsigned int size);
+
+	void Clear(); //Free all tiles, called before allocating tiles for the frame (rects stay, so they can be kept)
+	void Keep(int firstTile, unsigned int count); //Mark tiles allocated in previous frame as used again, same place in the atlas
+	int Allocate(unsigned int tileSize, unsigned int count); //Returns index of first of count consecutive tiles, or -1 when atlas is full
+	void SetTileMatrix(int tile, const glm::mat4& lightTransform);
+	void UploadTiles(); //Send tile rects and matrices to the uniform buffer
+
+	void BindTile(int tile); //Set viewport and scissor to the tile (FBO has to be bound)
+	void BindMomentsTile(int tile); //Bind moments FBO and set viewport to the tile in the moments atlas
+	void BindBlurTarget(int tile); //Bind blur FBO and set viewport to the area of blur texture used for the tile
+	glm::vec4 GetTileRect(int tile) { return tileBlock.rects[tile]; } //In atlas uv (same for depth and moments atlas)
+	glm::vec4 GetBlurRect(int tile); //Area of blur texture used for the tile, in its uv
+
+	GLuint GetUBO() { return UBO; } //Bound to SHADOW_TILES_UBO_BINDING by command lists of passes that read it
+	GLsizeiptr GetTileBlockSize() { return sizeof(TileBlock); }
+	GLuint GetFBO() { return FBO; }
+	GLuint GetTexture() { return atlasTexture; }
+	GLuint GetMomentsTexture() { return momentsTexture; }
+	GLuint GetBlurTexture() { return blurTexture; }
+	GLuint GetBlurSize() { return blurSize; }
+	GLuint GetSize() { return atlasSize; }
+	unsigned int GetTileCount() { return tileCount; } //Tiles in use
+	unsigned int GetUsedArea() { return usedArea; } //In texels
+
+	~ShadowAtlas();
+
+private:
+	struct TileBlock //std140 layout of ShadowTiles uniform block
+	{
+		glm::vec4 rects[MAX_SHADOW_TILES]; //xy - offset, zw - size (in atlas uv)
+		glm::mat4 matrices[MAX_SHADOW_TILES]; //Projection * view of the light for the tile
+	};
+
+	GLuint FBO;
+	GLuint atlasTexture;
+	GLuint UBO;
+	unsigned int atlasSize;
+
+	GLuint momentsFBO, momentsTexture;
+	GLuint blurFBO, blurTexture; //Holds one horizontally blurred tile
+	unsigned int blurSize;
+
+	unsigned int tileCount;
+	unsigned int usedArea;
+	glm::uvec4 tileRects[MAX_SHADOW_TILES]; //In texels
+	unsigned int tileFirstCell[MAX_SHADOW_TILES]; //Morton index of the first cell covered by the tile
+	bool tileUsed[MAX_SHADOW_TILES];
+	std::vector<bool> cellUsed; //MIN_SHADOW_TILE_SIZE squares in Morton order
+	TileBlock tileBlock;
+
+	void MarkTileUsed(int tile);
+	bool IsBlockFree(unsigned int firstCell, unsigned int cellCount);
+	static unsigned int DecodeMorton(unsigned int code); //Take every second bit
+	static bool CreateColorTarget(GLuint& framebuffer, GLuint& texture, unsigned int size);
+};
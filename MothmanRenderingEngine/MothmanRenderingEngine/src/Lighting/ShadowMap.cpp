@@ -1,5 +1,7 @@
 #include "ShadowMap.h"
 
+#include "..\GLState.h"
+
 ShadowMap::ShadowMap()
 {
 	FBO = 0;
@@ -14,7 +16,7 @@ bool ShadowMap::Init(unsigned int width, unsigned int height)
 	glGenFramebuffers(1, &FBO); //Generate framebuffer object name (generated name will be stored in FBO)
 
 	glGenTextures(1, &shadowMap); //Generate texture
-	glBindTexture(GL_TEXTURE_2D, shadowMap); //Bind texture
+	GLState::BindTexture(GL_TEXTURE_2D, shadowMap); //Bind texture
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr); //Depth texture initialization 
 
 
@@ -35,7 +37,7 @@ bool ShadowMap::Init(unsigned int width, unsigned int height)
 	glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
 	*/
 
-	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO); //Bind FBO(generated FBO name) to the framebuffer [There is only one framebuffer! we just change where it is writing data to!]
+	GLState::BindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO); //Bind FBO(generated FBO name) to the framebuffer [There is only one framebuffer! we just change where it is writing data to!]
 	glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, shadowMap, 0); //Connect the framebuffer to the texture so if framebuffer got updated result will be stored in a texture
 
 	glDrawBuffer(GL_NONE); //Draw scene (only depth)
@@ -48,7 +50,7 @@ bool ShadowMap::Init(unsigned int width, unsigned int height)
 		return false;
 	}
 
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
 	return true;
 }
 
@@ -57,10 +59,12 @@ ShadowMap::~ShadowMap()
 	if (FBO)
 	{
 		glDeleteFramebuffers(1, &FBO);
+		GLState::ForgetFramebuffer(FBO);
 	}
 
 	if (shadowMap)
 	{
 		glDeleteTextures(1, &shadowMap);
+		GLState::ForgetTexture(shadowMap);
 	}
 }
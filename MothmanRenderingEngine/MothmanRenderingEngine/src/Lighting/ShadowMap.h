@@ -16,7 +16,7 @@ public:
 	GLuint GetShadowWidth() { return shadowWidth; }
 	GLuint GetShadowHeight() { return shadowHeight; }
 
-	~ShadowMap();
+	virtual ~ShadowMap(); //Lights own their maps through ShadowMap pointer, derived maps are deleted through it
 protected:
 	GLuint shadowMap; //Shadow map texture
 	GLuint FBO; //Framebuffer object 
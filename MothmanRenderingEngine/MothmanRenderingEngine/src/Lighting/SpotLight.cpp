@@ -22,6 +22,22 @@ SpotLight::SpotLight(GLfloat shadowWidth, GLfloat shadowHeight,
 	procEdge = cosf(glm::radians(edge));
 }
 
+void SpotLight::UpdateLightTransforms()
+{
+	glm::vec3 up = glm::abs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f); //Any up vector that is not parallel to direction
+	faceViews[0] = glm::lookAt(position, position + direction, up);
+	lightTransforms[0] = GetShadowProjection(farPlane) * faceViews[0];
+
+	lightTransformsDirty = false;
+	faceFrustaRange = -1.0f;
+}
+
+glm::mat4 SpotLight::GetShadowProjection(GLfloat far)
+{
+	float fov = glm::clamp(edge * 2.0f + 5.0f, 1.0f, 170.0f); //Whole cone plus a few degrees for PCF samples at its border
+	return glm::perspective(glm::radians(fov), 1.0f, nearPlane, far);
+}
+
 SpotLight::~SpotLight()
 {
 
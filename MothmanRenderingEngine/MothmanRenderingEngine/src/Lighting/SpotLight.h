@@ -19,8 +19,14 @@ public:
 	GLfloat GetEdge() { return edge; }
 	GLfloat GetProcEdge() { return procEdge; } 
 
+	int GetShadowFaceCount() { return 1; } //Cone fits into one perspective frustum
+
 	~SpotLight();
 
+protected:
+	void UpdateLightTransforms();
+	glm::mat4 GetShadowProjection(GLfloat far);
+
 private:
 	glm::vec3 direction;
 	GLfloat edge, procEdge;
@@ -0,0 +1,63 @@
+#include "LinearAllocator.h"
+
+LinearAllocator::LinearAllocator(size_t blockSize)
+{
+	this->blockSize = blockSize;
+	currentBlock = 0;
+}
+
+void* LinearAllocator::Allocate(size_t size, size_t alignment)
+{
+	while (currentBlock < blocks.size())
+	{
+		Block& block = blocks[currentBlock];
+		uintptr_t base = (uintptr_t)&block.memory[0];
+		size_t offset = ((base + block.used + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+		if (offset + size <= block.memory.size())
+		{
+			block.used = offset + size;
+			return &block.memory[offset];
+		}
+		currentBlock++; //Rest of the block stays unused until Reset
+	}
+
+	Block block;
+	block.memory.resize(size + alignment > blockSize ? size + alignment : blockSize);
+	block.used = 0;
+	blocks.push_back(std::move(block)); //Moving the vector keeps its memory, pointers into older blocks stay valid
+	currentBlock = blocks.size() - 1;
+	return Allocate(size, alignment);
+}
+
+void LinearAllocator::Reset()
+{
+	for (size_t i = 0; i < blocks.size(); i++)
+	{
+		blocks[i].used = 0;
+	}
+	currentBlock = 0;
+}
+
+size_t LinearAllocator::GetUsedBytes()
+{
+	size_t used = 0;
+	for (size_t i = 0; i < blocks.size(); i++)
+	{
+		used += blocks[i].used;
+	}
+	return used;
+}
+
+size_t LinearAllocator::GetReservedBytes()
+{
+	size_t reserved = 0;
+	for (size_t i = 0; i < blocks.size(); i++)
+	{
+		reserved += blocks[i].memory.size();
+	}
+	return reserved;
+}
+
+LinearAllocator::~LinearAllocator()
+{
+}
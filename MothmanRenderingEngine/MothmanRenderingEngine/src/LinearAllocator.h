@@ -0,0 +1,44 @@
+/*
+Linear allocator
+
+Memory for data rebuilt every frame (command buffers). Allocation moves a pointer forward inside the current block, nothing is freed
+one by one, Reset rewinds to the first block and keeps all blocks, so once the first frames grew it there are no heap allocations.
+Blocks have blockSize bytes, allocation that doesn't fit into the rest of the current block continues in the next one, allocation bigger
+than blockSize gets a block of its own size. Memory never moves, pointers stay valid until Reset.
+Not thread safe, every recording thread has its own allocator.
+*/
+
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+class LinearAllocator
+{
+public:
+	LinearAllocator(size_t blockSize);
+
+	void* Allocate(size_t size, size_t alignment); //Alignment is a power of two, at most 16
+	template<typename T> T* Allocate(size_t count) { return (T*)Allocate(sizeof(T) * count, alignof(T)); }
+	void Reset();
+
+	size_t GetBlockCount() { return blocks.size(); }
+	const uint8_t* GetBlockData(size_t block) { return &blocks[block].memory[0]; }
+	size_t GetBlockUsed(size_t block) { return blocks[block].used; } //Bytes from the start of the block, including alignment padding
+	size_t GetUsedBytes();
+	size_t GetReservedBytes();
+
+	~LinearAllocator();
+
+private:
+	struct Block
+	{
+		std::vector<uint8_t> memory;
+		size_t used;
+	};
+
+	std::vector<Block> blocks;
+	size_t currentBlock;
+	size_t blockSize;
+};
@@ -1,16 +1,19 @@
 #include "Material.h"
 
+GLuint Material::materialCount = 0;
 
 Material::Material()
 {
 	specularIntensity = 0.0f;
 	shininess = 0.0f;
+	materialID = 0;
 }
 
 Material::Material(GLfloat sIntensity, GLfloat shine)
 {
 	specularIntensity = sIntensity;
 	shininess = shine;
+	materialID = ++materialCount;
 }
 
 void Material::UseMaterial(Shader *shader, const string& specularIntensityUniformName, const string& shininessUniformName)
@@ -10,10 +10,16 @@ public:
 	Material(GLfloat sIntensity, GLfloat shine);
 
 	void UseMaterial(Shader *shader, const string& specularIntensityUniformName, const string& shininessUniformName);
+	GLuint GetMaterialID() { return materialID; }
+	GLfloat GetSpecularIntensity() { return specularIntensity; }
+	GLfloat GetShininess() { return shininess; }
 
 	~Material();
 
 private:
 	GLfloat specularIntensity; //How bright the light reflected is
 	GLfloat shininess; //How much the reflection is concentrated or diffused
+	GLuint materialID; //Unique, small number used in render queue sort keys (0 - default material)
+
+	static GLuint materialCount;
 };
@@ -1,6 +1,11 @@
 #include "Mesh.h"
 
 #include <iostream>
+#include <limits>
+
+#include "CommonValues.h"
+#include "RenderStats.h"
+#include "GLState.h"
 
 Mesh::Mesh()
 {
@@ -8,6 +13,11 @@ Mesh::Mesh()
 	VBO = 0;
 	IBO = 0;
 	indexCount = 0;
+
+	aabbMin = glm::vec3(0.0f, 0.0f, 0.0f);
+	aabbMax = glm::vec3(0.0f, 0.0f, 0.0f);
+	boundingSphereCenter = glm::vec3(0.0f, 0.0f, 0.0f);
+	boundingSphereRadius = std::numeric_limits<float>::infinity();
 }
 
 void Mesh::CreateMesh(float *vertices, unsigned int *indices, unsigned int numOfVertices, unsigned int numOfIndices)
@@ -17,17 +27,19 @@ void Mesh::CreateMesh(float *vertices, unsigned int *indices, unsigned int numOf
 	indexCount = numOfIndices;
 
 	glGenVertexArrays(1, &VAO); //Creates one identifier for VAO and stores it in VAO variable (Allocates space for VAOs in GPU)
-	glBindVertexArray(VAO); //Make VAO active, Associate the set of vertex array data with individual allocated objects
+	GLState::BindVertexArray(VAO); //Make VAO active, Associate the set of vertex array data with individual allocated objects
 
 
 
 	glGenBuffers(1, &IBO); //Creates one identifier for IBO, second parameter is IBO where generated identifiers will be stored (Allocates space for VAOs in GPU)
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO); //Associating created IBO identifier with IBO (GL_ELEMENT_ARRAY_BUFFER - type of IBO that we use, IBO - is buffer identifier)
+	GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO); //Associating created IBO identifier with IBO (GL_ELEMENT_ARRAY_BUFFER - type of IBO that we use, IBO - is buffer identifier)
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices[0]) * numOfIndices, indices, GL_STATIC_DRAW);
+	RenderStats::Add(RENDER_STAT_BUFFER_UPLOAD_BYTES, sizeof(indices[0]) * numOfIndices);
 
 	glGenBuffers(1, &VBO); //Creates one identifier for VBO, second parameter is VBO where generated identifiers will be stored (Allocates space for VAOs in GPU)
-	glBindBuffer(GL_ARRAY_BUFFER, VBO); //Associating created VBO identifier with VBO (GL_ARRAY_BUFFER VBO - type of VBO that we use, VBO - is buffer identifier)
+	GLState::BindBuffer(GL_ARRAY_BUFFER, VBO); //Associating created VBO identifier with VBO (GL_ARRAY_BUFFER VBO - type of VBO that we use, VBO - is buffer identifier)
 	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices[0]) * numOfVertices, vertices, GL_STATIC_DRAW); //Upload data into active buffer (GL_ARRAY_BUFFER - type of VBO that we use, GL_STATIC_DRAW - method of accessing data)
+	RenderStats::Add(RENDER_STAT_BUFFER_UPLOAD_BYTES, sizeof(vertices[0]) * numOfVertices);
 
 	//Passing values into vertex shader (layout (location = 0) in vec3 pos)
 	//Nr, how many values to pass, , , total values for each vertex, how many skip before passing 
@@ -40,23 +52,39 @@ void Mesh::CreateMesh(float *vertices, unsigned int *indices, unsigned int numOf
 	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(vertices[0]) * 11, (void*)(sizeof(vertices[0]) * 8)); //(Tangent coordinates)
 	glEnableVertexAttribArray(3);
 
-	glBindBuffer(GL_ARRAY_BUFFER, 0); //Unbinding
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); //Unbinding
+	GLState::BindBuffer(GL_ARRAY_BUFFER, 0); //Unbinding (IBO stays bound, VAO remembers it so binding VAO is enough to draw)
+
+	GLState::BindVertexArray(0); //Unbinding VAO
+	GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); //Unbinding (have to be called after unbinding VAO)
+
+}
 
-	glBindVertexArray(0); //Unbinding VAO
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); //Unbinding (have to be called after unbinding VAO)
+void Mesh::SetBounds(const glm::vec3& min, const glm::vec3& max)
+{
+	aabbMin = min;
+	aabbMax = max;
+	boundingSphereCenter = (min + max) * 0.5f;
+	boundingSphereRadius = glm::length(max - min) * 0.5f; //Sphere around AABB, not the tightest one but cheap and stable
+}
 
+void Mesh::SetOccluderGeometry(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices)
+{
+	occluderPositions = positions;
+	occluderIndices = indices;
 }
 
 void Mesh::RenderMesh()
 {
-	glBindVertexArray(VAO); //Associate VAO with current active buffer
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+	GLState::BindVertexArray(VAO); //IBO binding is part of VAO state, VAO stays bound (next draw binds its own)
 
 	glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);  //Draw by elements: 0 - first vertex, 3 - number of vertex
+	RenderStats::AddDraw(indexCount / 3);
+}
 
-	glBindVertexArray(0);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+void Mesh::DrawMesh()
+{
+	glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+	RenderStats::AddDraw(indexCount / 3);
 }
 
 void Mesh::ClearMesh() //Deleting the buffer of GPU memory because there is no garbage collections so we need to delete this manually
@@ -64,11 +92,13 @@ void Mesh::ClearMesh() //Deleting the buffer of GPU memory because there is no g
 	if (VBO != 0)
 	{
 		glDeleteBuffers(1, &VBO);
+		GLState::ForgetBuffer(VBO);
 		VBO = 0;
 	}
 	if (VAO != 0)
 	{
-		glDeleteBuffers(1, &VAO);
+		glDeleteVertexArrays(1, &VAO);
+		GLState::ForgetVertexArray(VAO);
 		VAO = 0;
 	}
 	if (IBO != 0)
@@ -77,6 +107,8 @@ void Mesh::ClearMesh() //Deleting the buffer of GPU memory because there is no g
 		IBO = 0;
 	}
 	indexCount = 0;
+	occluderPositions.clear();
+	occluderIndices.clear();
 }
 
 Mesh::~Mesh()
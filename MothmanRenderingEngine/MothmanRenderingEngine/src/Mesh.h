@@ -1,6 +1,9 @@
 #pragma once
 
+#include <vector>
+
 #include <GL\glew.h>
+#include <glm\glm.hpp>
 
 class Mesh
 {
@@ -9,11 +12,34 @@ public:
 
 	void CreateMesh(float *vertices, unsigned int *indices, unsigned int numOfVertices, unsigned int numOfIndices); //
 	void RenderMesh(); //Draw mesh to the screen
+	void DrawMesh(); //Draw already bound mesh
 	void ClearMesh(); //Remove mesh from the GPU
 
+	void SetBounds(const glm::vec3& min, const glm::vec3& max); //Set local space AABB, bounding sphere is calculated from it
+
+	glm::vec3 GetAABBMin() { return aabbMin; }
+	glm::vec3 GetAABBMax() { return aabbMax; }
+	glm::vec3 GetBoundingSphereCenter() { return boundingSphereCenter; }
+	float GetBoundingSphereRadius() { return boundingSphereRadius; }
+
+	void SetOccluderGeometry(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices); //CPU copy of triangles for software occlusion culling
+	bool HasOccluderGeometry() { return !occluderIndices.empty(); }
+	const std::vector<glm::vec3>& GetOccluderPositions() { return occluderPositions; }
+	const std::vector<unsigned int>& GetOccluderIndices() { return occluderIndices; }
+
+	GLuint GetVAO() { return VAO; } //Render queue records binds and instanced draws of the VAO into command buffers
+	GLsizei GetIndexCount() { return indexCount; }
+
 	~Mesh();
 private:
 	GLuint VAO, VBO, IBO;
 	GLsizei indexCount;
+
+	glm::vec3 aabbMin, aabbMax;
+	glm::vec3 boundingSphereCenter;
+	float boundingSphereRadius; //Infinite until bounds are set, so meshes without bounds are never culled
+
+	std::vector<glm::vec3> occluderPositions;
+	std::vector<unsigned int> occluderIndices;
 };
 
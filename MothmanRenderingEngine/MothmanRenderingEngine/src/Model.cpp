@@ -26,7 +26,19 @@ void Model::RenderModel()
 	}
 }
 
-void Model::LoadModel(const std::string & fileName)
+Texture* Model::GetMeshTexture(size_t meshIndex, TexType texType)
+{
+	size_t textureIndex = meshToTex[meshIndex] * TEXTURES_PER_MATERIAL;
+	if (texType == TexType::Normal) { textureIndex += 1; } //Diffuse texture is first, normal texture is second in each material slot
+
+	if (textureIndex < textureList.size())
+	{
+		return textureList[textureIndex];
+	}
+	return nullptr;
+}
+
+void Model::LoadModel(const std::string & fileName, bool occluder)
 {
 	Assimp::Importer importer;
 	const aiScene *scene = importer.ReadFile(fileName, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices);
@@ -37,35 +49,40 @@ void Model::LoadModel(const std::string & fileName)
 		return;
 	}
 
-	LoadNode(scene->mRootNode, scene);
+	LoadNode(scene->mRootNode, scene, occluder);
 
 	LoadMaterials(scene);
 	//std::cout << "Model " << fileName << " failed to load" << std::endl;
 	//printf("Model %s loaded successfully", fileName);
 }
 
-void Model::LoadNode(aiNode * node, const aiScene * scene)
+void Model::LoadNode(aiNode * node, const aiScene * scene, bool occluder)
 {
 	//One model can have separate meshes (like Unity reading mesh as multiple meshes selected when exporting in Blender)
 	for (size_t i = 0; i < node->mNumMeshes; i++)
 	{
-		LoadMesh(scene->mMeshes[node->mMeshes[i]], scene); //node->mMeshes[i] - holds id of mesh in node, but actual mesh is stored in scene
+		LoadMesh(scene->mMeshes[node->mMeshes[i]], scene, occluder); //node->mMeshes[i] - holds id of mesh in node, but actual mesh is stored in scene
 	}
 
 	for (size_t i = 0; i < node->mNumChildren; i++)
 	{
-		LoadNode(node->mChildren[i], scene);
+		LoadNode(node->mChildren[i], scene, occluder);
 	}
 }
 
-void Model::LoadMesh(aiMesh * mesh, const aiScene * scene)
+void Model::LoadMesh(aiMesh * mesh, const aiScene * scene, bool occluder)
 {
 	std::vector<GLfloat> vertices;
 	std::vector<unsigned int> indices;
 
+	glm::vec3 boundsMin = glm::vec3(mesh->mVertices[0].x, mesh->mVertices[0].y, mesh->mVertices[0].z);
+	glm::vec3 boundsMax = boundsMin;
+
 	for (size_t i = 0; i < mesh->mNumVertices; i++) //For each vertex in mesh read from file
 	{
 		vertices.insert(vertices.end(), { mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z }); //Adding vertex coordinates to the list of vertices
+		boundsMin = glm::min(boundsMin, glm::vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z)); //Growing AABB of the mesh
+		boundsMax = glm::max(boundsMax, glm::vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z));
 		if (mesh->mTextureCoords[0]) //Check if mesh has texture/UV coordinates
 		{
 			vertices.insert(vertices.end(), { mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y }); //Adding texture/UV coordinates to the list of vertices
@@ -94,6 +111,16 @@ void Model::LoadMesh(aiMesh * mesh, const aiScene * scene)
 
 	Mesh* newMesh = new Mesh();
 	newMesh->CreateMesh(&vertices[0], &indices[0], vertices.size(), indices.size());
+	newMesh->SetBounds(boundsMin, boundsMax);
+	if (occluder)
+	{
+		std::vector<glm::vec3> positions(mesh->mNumVertices);
+		for (size_t i = 0; i < mesh->mNumVertices; i++)
+		{
+			positions[i] = glm::vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
+		}
+		newMesh->SetOccluderGeometry(positions, indices);
+	}
 	meshList.push_back(newMesh);
 	meshToTex.push_back(mesh->mMaterialIndex);
 
@@ -105,7 +132,7 @@ void Model::LoadMaterials(const aiScene * scene)
 
 	for (size_t i = 0; i < scene->mNumMaterials; i++) //For each material on scene (sum of materials of all loaded models)
 	{
-		int texturListOffset = 0;
+		int texturListOffset = i * TEXTURES_PER_MATERIAL; //Each material has its own slot of textures
 		aiMaterial* material = scene->mMaterials[i]; //Get one material
 
 		textureList[texturListOffset] = nullptr;
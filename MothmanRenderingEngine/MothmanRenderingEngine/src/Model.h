@@ -19,16 +19,20 @@ class Model
 public:
 	Model();
 
-	void LoadModel(const std::string& fileName);
+	void LoadModel(const std::string& fileName, bool occluder = false); //Occluder meshes keep CPU copy of their triangles for software occlusion culling
 	void RenderModel();
 	void ClearModel();
 
+	size_t GetMeshCount() { return meshList.size(); }
+	Mesh* GetMesh(size_t meshIndex) { return meshList[meshIndex]; }
+	Texture* GetMeshTexture(size_t meshIndex, TexType texType); //Texture of given type from the material assigned to the mesh
+
 	~Model();
 
 private:
 
-	void LoadNode(aiNode *node, const aiScene *scene);
-	void LoadMesh(aiMesh *mesh, const aiScene *scene);
+	void LoadNode(aiNode *node, const aiScene *scene, bool occluder);
+	void LoadMesh(aiMesh *mesh, const aiScene *scene, bool occluder);
 	void LoadMaterials(const aiScene *scene);
 	
 	std::vector<Mesh*> meshList; //Storing all meshes
@@ -0,0 +1,414 @@
+#include "OcclusionCuller.h"
+
+#include <algorithm>
+#include <float.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#define OCCLUSION_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+#include "JobSystem.h"
+
+static const float OCCLUSION_MIN_OCCLUDER_SIZE = 0.05f; //Occluders with smaller radius / distance cover only few pixels and hide almost nothing
+static const size_t OCCLUSION_JOBS_MIN_TRIANGLES = 2048; //Below this scheduling jobs costs more than rasterization itself
+static const size_t OCCLUSION_TILES_PER_JOB = 8;
+
+static const unsigned int BOX_INDICES[36] = //Corner index bits: x - 1, y - 2, z - 4. Counter-clockwise seen from outside
+{
+	0, 4, 6, 0, 6, 2, //-X
+	1, 3, 7, 1, 7, 5, //+X
+	0, 1, 5, 0, 5, 4, //-Y
+	2, 6, 7, 2, 7, 3, //+Y
+	0, 2, 3, 0, 3, 1, //-Z
+	4, 5, 7, 4, 7, 6, //+Z
+};
+
+OcclusionCuller::OcclusionCuller()
+{
+	depthBuffer.resize(OCCLUSION_BUFFER_WIDTH * OCCLUSION_BUFFER_HEIGHT, 0.0f);
+	for (int i = 0; i < TILE_COUNT; i++) { tileFarthest[i] = 0.0f; }
+	rasterized = false;
+	occluderCount = 0;
+	triangleCount = 0;
+	rasterizedTriangleCount = 0;
+	testedCount = 0;
+	occludedCount = 0;
+	binJobCount = 0;
+}
+
+void OcclusionCuller::Begin(const glm::mat4& viewProjection, const glm::vec3& viewPosition)
+{
+	this->viewProjection = viewProjection;
+	this->viewPosition = viewPosition;
+	frustum.ExtractPlanes(viewProjection);
+	rasterized = false;
+	occluders.clear();
+	boxCorners.clear();
+	testedCount = 0;
+	occludedCount = 0;
+}
+
+void OcclusionCuller::AddMesh(Mesh* mesh, const glm::mat4& transform)
+{
+	if (!mesh->HasOccluderGeometry()) { return; }
+
+	//World space bounding sphere, same as in render queue
+	glm::vec3 center = glm::vec3(transform * glm::vec4(mesh->GetBoundingSphereCenter(), 1.0f));
+	float scale = glm::max(glm::length(glm::vec3(transform[0])), glm::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+	float radius = mesh->GetBoundingSphereRadius() * scale;
+	float distance = glm::length(center - viewPosition) - radius;
+
+	Occluder occluder;
+	occluder.positions = &mesh->GetOccluderPositions()[0];
+	occluder.indices = &mesh->GetOccluderIndices()[0];
+	occluder.triangleCount = (unsigned int)mesh->GetOccluderIndices().size() / 3;
+	occluder.boxIndex = 0;
+	occluder.toClip = viewProjection * transform;
+	occluder.screenSize = distance > 0.0f ? radius / distance : FLT_MAX; //Camera inside of the sphere
+	occluders.push_back(occluder);
+}
+
+void OcclusionCuller::AddBox(const glm::vec3& min, const glm::vec3& max)
+{
+	glm::vec3 center = (min + max) * 0.5f;
+	float radius = glm::length(max - center);
+	if (!frustum.IntersectsSphere(center, radius)) { return; }
+
+	Occluder occluder;
+	occluder.positions = nullptr;
+	occluder.indices = BOX_INDICES;
+	occluder.triangleCount = 12;
+	occluder.boxIndex = boxCorners.size() / 8;
+	occluder.toClip = viewProjection;
+	float distance = glm::length(center - viewPosition) - radius;
+	occluder.screenSize = distance > 0.0f ? radius / distance : FLT_MAX;
+	occluders.push_back(occluder);
+
+	for (int corner = 0; corner < 8; corner++)
+	{
+		boxCorners.push_back(glm::vec3(corner & 1 ? max.x : min.x, corner & 2 ? max.y : min.y, corner & 4 ? max.z : min.z));
+	}
+}
+
+void OcclusionCuller::Rasterize()
+{
+	//Biggest occluders on screen first, until triangle budget is used
+	selectedOccluders.clear();
+	for (size_t i = 0; i < occluders.size(); i++)
+	{
+		if (occluders[i].screenSize >= OCCLUSION_MIN_OCCLUDER_SIZE) { selectedOccluders.push_back((uint32_t)i); }
+	}
+	std::sort(selectedOccluders.begin(), selectedOccluders.end(), [this](uint32_t a, uint32_t b) { return occluders[a].screenSize > occluders[b].screenSize; });
+
+	selectedFirstTriangles.clear();
+	size_t totalTriangles = 0;
+	size_t selectedCount = 0;
+	for (; selectedCount < selectedOccluders.size(); selectedCount++)
+	{
+		const Occluder& occluder = occluders[selectedOccluders[selectedCount]];
+		if (totalTriangles + occluder.triangleCount > (size_t)OCCLUSION_TRIANGLE_BUDGET) { break; }
+		selectedFirstTriangles.push_back(totalTriangles);
+		totalTriangles += occluder.triangleCount;
+	}
+	selectedOccluders.resize(selectedCount);
+	selectedFirstTriangles.push_back(totalTriangles);
+	occluderCount = (unsigned int)selectedCount;
+	triangleCount = (unsigned int)totalTriangles;
+
+	binJobCount = 1;
+	if (totalTriangles >= OCCLUSION_JOBS_MIN_TRIANGLES && JobSystem::GetWorkerCount() > 0)
+	{
+		binJobCount = OCCLUSION_BIN_JOBS;
+	}
+	for (int job = 0; job < OCCLUSION_BIN_JOBS; job++)
+	{
+		triangles[job].clear();
+		for (int tile = 0; tile < TILE_COUNT; tile++) { bins[job][tile].clear(); }
+	}
+
+	//Binning, every job gets the same number of triangles
+	size_t trianglesPerJob = (totalTriangles + binJobCount - 1) / binJobCount;
+	JobSystem::ParallelFor("Occlusion binning", binJobCount, 1, [this, trianglesPerJob, totalTriangles](size_t first, size_t last)
+	{
+		for (size_t job = first; job < last; job++)
+		{
+			BinTriangles((unsigned int)job, std::min(job * trianglesPerJob, totalTriangles), std::min((job + 1) * trianglesPerJob, totalTriangles));
+		}
+	});
+
+	rasterizedTriangleCount = 0;
+	for (unsigned int job = 0; job < binJobCount; job++) { rasterizedTriangleCount += (unsigned int)triangles[job].size(); }
+
+	//Rasterization, every job owns its tiles
+	JobSystem::ParallelFor("Occlusion rasterization", TILE_COUNT, binJobCount > 1 ? OCCLUSION_TILES_PER_JOB : TILE_COUNT, [this](size_t first, size_t last)
+	{
+		RasterizeTiles((int)first, (int)last);
+	});
+
+	rasterized = true;
+}
+
+void OcclusionCuller::BinTriangles(unsigned int job, size_t firstTriangle, size_t lastTriangle)
+{
+	if (firstTriangle >= lastTriangle) { return; }
+
+	//Selected occluder that holds the first triangle
+	size_t occluderIndex = std::upper_bound(selectedFirstTriangles.begin(), selectedFirstTriangles.end(), firstTriangle) - selectedFirstTriangles.begin() - 1;
+	size_t triangle = firstTriangle;
+	while (triangle < lastTriangle)
+	{
+		const Occluder& occluder = occluders[selectedOccluders[occluderIndex]];
+		const glm::vec3* positions = occluder.positions != nullptr ? occluder.positions : &boxCorners[occluder.boxIndex * 8];
+		size_t occluderLast = std::min(selectedFirstTriangles[occluderIndex + 1], lastTriangle);
+
+		for (; triangle < occluderLast; triangle++)
+		{
+			const unsigned int* indices = occluder.indices + (triangle - selectedFirstTriangles[occluderIndex]) * 3;
+			glm::vec4 clip0 = occluder.toClip * glm::vec4(positions[indices[0]], 1.0f);
+			glm::vec4 clip1 = occluder.toClip * glm::vec4(positions[indices[1]], 1.0f);
+			glm::vec4 clip2 = occluder.toClip * glm::vec4(positions[indices[2]], 1.0f);
+
+			//Near plane (z >= -w), part of the triangle in front of the camera is one or two triangles
+			float d0 = clip0.z + clip0.w, d1 = clip1.z + clip1.w, d2 = clip2.z + clip2.w;
+			if (d0 >= 0.0f && d1 >= 0.0f && d2 >= 0.0f)
+			{
+				BinTriangle(job, clip0, clip1, clip2);
+				continue;
+			}
+			if (d0 < 0.0f && d1 < 0.0f && d2 < 0.0f) { continue; }
+
+			glm::vec4 input[3] = { clip0, clip1, clip2 };
+			float distances[3] = { d0, d1, d2 };
+			glm::vec4 polygon[4];
+			int count = 0;
+			for (int i = 0; i < 3; i++)
+			{
+				int next = (i + 1) % 3;
+				if (distances[i] >= 0.0f) { polygon[count++] = input[i]; }
+				if ((distances[i] >= 0.0f) != (distances[next] >= 0.0f)) //Edge crosses the plane
+				{
+					float t = distances[i] / (distances[i] - distances[next]);
+					polygon[count++] = input[i] + (input[next] - input[i]) * t;
+				}
+			}
+			for (int i = 2; i < count; i++)
+			{
+				BinTriangle(job, polygon[0], polygon[i - 1], polygon[i]);
+			}
+		}
+		occluderIndex++;
+	}
+}
+
+void OcclusionCuller::BinTriangle(unsigned int job, const glm::vec4& clip0, const glm::vec4& clip1, const glm::vec4& clip2)
+{
+	const glm::vec4* clip[3] = { &clip0, &clip1, &clip2 };
+	float x[3], y[3], depth[3];
+	for (int i = 0; i < 3; i++)
+	{
+		if (clip[i]->w <= 0.0f) { return; } //Orthographic or degenerate projection
+		depth[i] = 1.0f / clip[i]->w;
+		x[i] = (clip[i]->x * depth[i] * 0.5f + 0.5f) * OCCLUSION_BUFFER_WIDTH;
+		y[i] = (clip[i]->y * depth[i] * 0.5f + 0.5f) * OCCLUSION_BUFFER_HEIGHT;
+	}
+
+	float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+	if (!(area > 0.0f)) { return; } //Back facing, degenerate or NaN
+
+	//Pixels with center inside of the triangle bounds (clamped before conversion, vertices near the near plane can be far off screen)
+	Triangle triangle;
+	triangle.minX = (int)ceilf(glm::clamp(glm::min(x[0], glm::min(x[1], x[2])) - 0.5f, 0.0f, (float)OCCLUSION_BUFFER_WIDTH));
+	triangle.minY = (int)ceilf(glm::clamp(glm::min(y[0], glm::min(y[1], y[2])) - 0.5f, 0.0f, (float)OCCLUSION_BUFFER_HEIGHT));
+	triangle.maxX = glm::min((int)floorf(glm::clamp(glm::max(x[0], glm::max(x[1], x[2])) - 0.5f, -1.0f, (float)OCCLUSION_BUFFER_WIDTH)), OCCLUSION_BUFFER_WIDTH - 1);
+	triangle.maxY = glm::min((int)floorf(glm::clamp(glm::max(y[0], glm::max(y[1], y[2])) - 0.5f, -1.0f, (float)OCCLUSION_BUFFER_HEIGHT)), OCCLUSION_BUFFER_HEIGHT - 1);
+	if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) { return; } //Covers no pixel center or off screen
+
+	for (int i = 0; i < 3; i++)
+	{
+		int next = (i + 1) % 3;
+		float a = y[i] - y[next];
+		float b = x[next] - x[i];
+		float c = -(a * x[i] + b * y[i]);
+		triangle.edgeA[i] = a;
+		triangle.edgeB[i] = b;
+		triangle.edgeC[i] = c + 0.5f * (a + b); //Value at pixel center
+	}
+
+	float depthA = ((depth[1] - depth[0]) * (y[2] - y[0]) - (depth[2] - depth[0]) * (y[1] - y[0])) / area;
+	float depthB = ((depth[2] - depth[0]) * (x[1] - x[0]) - (depth[1] - depth[0]) * (x[2] - x[0])) / area;
+	triangle.depthA = depthA;
+	triangle.depthB = depthB;
+	triangle.depthC = depth[0] - depthA * x[0] - depthB * y[0] + glm::min(depthA, 0.0f) + glm::min(depthB, 0.0f); //Farthest corner of the pixel
+
+	uint32_t index = (uint32_t)triangles[job].size();
+	triangles[job].push_back(triangle);
+	for (int tileY = triangle.minY / OCCLUSION_TILE_HEIGHT; tileY <= triangle.maxY / OCCLUSION_TILE_HEIGHT; tileY++)
+	{
+		for (int tileX = triangle.minX / OCCLUSION_TILE_WIDTH; tileX <= triangle.maxX / OCCLUSION_TILE_WIDTH; tileX++)
+		{
+			bins[job][tileX + tileY * TILES_X].push_back(index);
+		}
+	}
+}
+
+void OcclusionCuller::RasterizeTiles(int firstTile, int lastTile)
+{
+	for (int tile = firstTile; tile < lastTile; tile++)
+	{
+		int tileMinX = (tile % TILES_X) * OCCLUSION_TILE_WIDTH;
+		int tileMinY = (tile / TILES_X) * OCCLUSION_TILE_HEIGHT;
+		int tileMaxX = tileMinX + OCCLUSION_TILE_WIDTH - 1;
+		int tileMaxY = tileMinY + OCCLUSION_TILE_HEIGHT - 1;
+
+		for (int y = tileMinY; y <= tileMaxY; y++)
+		{
+			std::fill(depthBuffer.begin() + y * OCCLUSION_BUFFER_WIDTH + tileMinX, depthBuffer.begin() + y * OCCLUSION_BUFFER_WIDTH + tileMaxX + 1, 0.0f);
+		}
+
+		for (unsigned int job = 0; job < binJobCount; job++)
+		{
+			const std::vector<uint32_t>& bin = bins[job][tile];
+			for (size_t i = 0; i < bin.size(); i++)
+			{
+				const Triangle& triangle = triangles[job][bin[i]];
+				RasterizeTriangle(triangle, glm::max(triangle.minX, tileMinX), glm::max(triangle.minY, tileMinY), glm::min(triangle.maxX, tileMaxX), glm::min(triangle.maxY, tileMaxY));
+			}
+		}
+
+		float farthest = FLT_MAX;
+		for (int y = tileMinY; y <= tileMaxY; y++)
+		{
+			const float* row = &depthBuffer[y * OCCLUSION_BUFFER_WIDTH];
+			for (int x = tileMinX; x <= tileMaxX; x++) { farthest = glm::min(farthest, row[x]); }
+		}
+		tileFarthest[tile] = farthest;
+	}
+}
+
+void OcclusionCuller::RasterizeTriangle(const Triangle& triangle, int minX, int minY, int maxX, int maxY)
+{
+	for (int y = minY; y <= maxY; y++)
+	{
+		float* row = &depthBuffer[y * OCCLUSION_BUFFER_WIDTH];
+		float edgeRow[3];
+		for (int i = 0; i < 3; i++) { edgeRow[i] = triangle.edgeB[i] * (float)y + triangle.edgeC[i]; }
+		float depthRow = triangle.depthB * (float)y + triangle.depthC;
+		int x = minX;
+
+#ifdef OCCLUSION_USE_SSE
+		//Tiles start at multiple of 4, pixels left of minX in the first group are rejected by edge functions
+		__m128 zero = _mm_setzero_ps();
+		__m128 lanes = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+		for (x = minX & ~3; x <= maxX; x += 4)
+		{
+			__m128 px = _mm_add_ps(_mm_set1_ps((float)x), lanes);
+			__m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.edgeA[0]), px), _mm_set1_ps(edgeRow[0])), zero);
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.edgeA[1]), px), _mm_set1_ps(edgeRow[1])), zero));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.edgeA[2]), px), _mm_set1_ps(edgeRow[2])), zero));
+			if (_mm_movemask_ps(inside) == 0) { continue; }
+
+			__m128 depth = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.depthA), px), _mm_set1_ps(depthRow));
+			__m128 current = _mm_loadu_ps(row + x);
+			__m128 nearer = _mm_max_ps(current, depth);
+			_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, current)));
+		}
+#endif
+
+		for (; x <= maxX; x++)
+		{
+			float fx = (float)x;
+			if (triangle.edgeA[0] * fx + edgeRow[0] >= 0.0f && triangle.edgeA[1] * fx + edgeRow[1] >= 0.0f && triangle.edgeA[2] * fx + edgeRow[2] >= 0.0f)
+			{
+				row[x] = glm::max(row[x], triangle.depthA * fx + depthRow);
+			}
+		}
+	}
+}
+
+bool OcclusionCuller::IsVisible(const glm::vec3& aabbMin, const glm::vec3& aabbMax, const glm::mat4& transform)
+{
+	if (!rasterized) { return true; }
+	testedCount++;
+
+	glm::mat4 toClip = viewProjection * transform;
+	float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+	float nearest = 0.0f;
+	for (int corner = 0; corner < 8; corner++)
+	{
+		glm::vec4 clip = toClip * glm::vec4(corner & 1 ? aabbMax.x : aabbMin.x, corner & 2 ? aabbMax.y : aabbMin.y, corner & 4 ? aabbMax.z : aabbMin.z, 1.0f);
+		if (clip.z < -clip.w || clip.w <= 0.0f) { return true; } //Crosses near plane
+
+		float depth = 1.0f / clip.w;
+		float x = (clip.x * depth * 0.5f + 0.5f) * OCCLUSION_BUFFER_WIDTH;
+		float y = (clip.y * depth * 0.5f + 0.5f) * OCCLUSION_BUFFER_HEIGHT;
+		minX = glm::min(minX, x);
+		minY = glm::min(minY, y);
+		maxX = glm::max(maxX, x);
+		maxY = glm::max(maxY, y);
+		nearest = glm::max(nearest, depth);
+	}
+
+	//Every pixel the box touches, even partially
+	int pixelMinX = (int)floorf(glm::clamp(minX, 0.0f, (float)OCCLUSION_BUFFER_WIDTH));
+	int pixelMinY = (int)floorf(glm::clamp(minY, 0.0f, (float)OCCLUSION_BUFFER_HEIGHT));
+	int pixelMaxX = (int)ceilf(glm::clamp(maxX, 0.0f, (float)OCCLUSION_BUFFER_WIDTH)) - 1;
+	int pixelMaxY = (int)ceilf(glm::clamp(maxY, 0.0f, (float)OCCLUSION_BUFFER_HEIGHT)) - 1;
+	if (pixelMinX > pixelMaxX || pixelMinY > pixelMaxY) { return true; } //Off screen, frustum culling decides
+
+	if (IsRectangleVisible(pixelMinX, pixelMinY, pixelMaxX, pixelMaxY, nearest)) { return true; }
+	occludedCount++;
+	return false;
+}
+
+bool OcclusionCuller::IsRectangleVisible(int minX, int minY, int maxX, int maxY, float depth)
+{
+	for (int tileY = minY / OCCLUSION_TILE_HEIGHT; tileY <= maxY / OCCLUSION_TILE_HEIGHT; tileY++)
+	{
+		for (int tileX = minX / OCCLUSION_TILE_WIDTH; tileX <= maxX / OCCLUSION_TILE_WIDTH; tileX++)
+		{
+			if (tileFarthest[tileX + tileY * TILES_X] > depth) { continue; } //Whole tile is nearer than the box
+
+			int rectMinX = glm::max(minX, tileX * OCCLUSION_TILE_WIDTH);
+			int rectMaxX = glm::min(maxX, (tileX + 1) * OCCLUSION_TILE_WIDTH - 1);
+			int rectMinY = glm::max(minY, tileY * OCCLUSION_TILE_HEIGHT);
+			int rectMaxY = glm::min(maxY, (tileY + 1) * OCCLUSION_TILE_HEIGHT - 1);
+			for (int y = rectMinY; y <= rectMaxY; y++)
+			{
+				const float* row = &depthBuffer[y * OCCLUSION_BUFFER_WIDTH];
+				int x = rectMinX;
+
+#ifdef OCCLUSION_USE_SSE
+				__m128 boxDepth = _mm_set1_ps(depth);
+				for (; x + 4 <= rectMaxX + 1; x += 4)
+				{
+					if (_mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(row + x), boxDepth)) != 0) { return true; } //Pixel not nearer than the box
+				}
+#endif
+
+				for (; x <= rectMaxX; x++)
+				{
+					if (row[x] <= depth) { return true; }
+				}
+			}
+		}
+	}
+	return false;
+}
+
+OcclusionStats OcclusionCuller::GetStats()
+{
+	OcclusionStats stats;
+	stats.occluders = occluderCount;
+	stats.submittedOccluders = (unsigned int)occluders.size();
+	stats.triangles = triangleCount;
+	stats.rasterizedTriangles = rasterizedTriangleCount;
+	stats.tested = testedCount;
+	stats.occluded = occludedCount;
+	stats.binJobs = binJobCount;
+	return stats;
+}
+
+OcclusionCuller::~OcclusionCuller()
+{
+}
@@ -0,0 +1,107 @@
+/*
+Software occlusion culling
+
+Each frame selected occluders (meshes with CPU copy of their triangles, boxes hidden under terrain) are rasterized on CPU into a low resolution
+depth buffer (OCCLUSION_BUFFER_WIDTH * OCCLUSION_BUFFER_HEIGHT), then camera visible packets are tested against it and hidden ones are removed
+from the draw list before depth and main pass, in the style of Intel's Masked Occlusion Culling (without its coverage masks).
+
+Depth buffer stores 1 / w (w - view depth), which changes linearly across a triangle in screen space, bigger value is nearer, 0 is empty.
+Buffer is split into OCCLUSION_TILE_WIDTH * OCCLUSION_TILE_HEIGHT tiles, second level of the hierarchy keeps the farthest depth of every tile.
+
+Rasterization in two phases, each split into jobs (JobSystem::ParallelFor, calling thread helps and returns when the phase is done):
+- binning: occluder triangles are divided evenly between OCCLUSION_BIN_JOBS jobs, each job transforms them to clip space, clips them by near plane,
+  drops back faces and triangles that don't cover any pixel center, and puts the rest into its own bins of tiles the triangle overlaps
+- rasterization: tiles are divided between jobs, each job draws triangles from bins of all binning jobs into its tiles, so no two jobs
+  write the same pixel. Four pixels of a row are tested and written at once with SSE (scalar path for builds without SSE)
+
+Depth is conservative, coverage is the same as on GPU:
+- pixel is written when its center is inside of the triangle (edges are inclusive, so triangles sharing an edge leave no holes),
+  with the farthest depth of the triangle plane inside the pixel. Silhouettes can grow by up to half of a low resolution pixel
+- occludee test uses screen rectangle of its projected AABB with depth of its nearest corner, tiles whose farthest depth is nearer are accepted
+  without touching pixels, rest of the rectangle is tested per pixel. AABB crossing near plane is always visible.
+Occluders are sorted by size on screen (bounding sphere radius / distance), small ones are skipped and at most OCCLUSION_TRIANGLE_BUDGET triangles are drawn.
+*/
+
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+#include <glm\glm.hpp>
+
+#include "CommonValues.h"
+#include "Mesh.h"
+#include "Frustum.h"
+
+struct OcclusionStats
+{
+	unsigned int occluders = 0; //Occluders drawn
+	unsigned int submittedOccluders = 0;
+	unsigned int triangles = 0; //Occluder triangles sent to binning
+	unsigned int rasterizedTriangles = 0; //Triangles that survived clipping, back face and size tests
+	unsigned int tested = 0;
+	unsigned int occluded = 0;
+	unsigned int binJobs = 0; //1 when there were few triangles or no workers
+};
+
+class OcclusionCuller
+{
+public:
+	OcclusionCuller();
+
+	void Begin(const glm::mat4& viewProjection, const glm::vec3& viewPosition); //Forget occluders and results of previous frame
+	void AddMesh(Mesh* mesh, const glm::mat4& transform); //Mesh has to have occluder geometry, it has to stay alive until Rasterize
+	void AddBox(const glm::vec3& min, const glm::vec3& max); //World space box, all of it has to be hidden behind real geometry
+	void Rasterize(); //Select occluders and draw them into depth buffer
+	bool IsVisible(const glm::vec3& aabbMin, const glm::vec3& aabbMax, const glm::mat4& transform); //Local space AABB with model matrix
+
+	OcclusionStats GetStats(); //Of last frame, copied into frame packet, GUI shows the copy
+	const float* GetDepthBuffer() { return &depthBuffer[0]; } //1 / w, row 0 at the bottom of the screen
+
+	~OcclusionCuller();
+
+private:
+	static const int TILES_X = OCCLUSION_BUFFER_WIDTH / OCCLUSION_TILE_WIDTH;
+	static const int TILES_Y = OCCLUSION_BUFFER_HEIGHT / OCCLUSION_TILE_HEIGHT;
+	static const int TILE_COUNT = TILES_X * TILES_Y;
+
+	struct Occluder
+	{
+		const glm::vec3* positions; //nullptr for boxes, their corners are in boxCorners
+		const unsigned int* indices;
+		unsigned int triangleCount;
+		size_t boxIndex;
+		glm::mat4 toClip; //View projection * model
+		float screenSize; //Bounding sphere radius / distance, bigger is drawn first
+	};
+
+	struct Triangle //Screen space setup, functions take pixel index (x, y) and offsets to pixel center or corner are folded into c
+	{
+		float edgeA[3], edgeB[3], edgeC[3]; //Edge function a * x + b * y + c, not negative when pixel center is inside of the edge
+		float depthA, depthB, depthC; //Farthest 1 / w of the pixel
+		int minX, minY, maxX, maxY; //Pixels with center inside of the triangle bounds (inclusive)
+	};
+
+	glm::mat4 viewProjection;
+	glm::vec3 viewPosition;
+	Frustum frustum;
+	bool rasterized;
+
+	std::vector<Occluder> occluders;
+	std::vector<glm::vec3> boxCorners; //Eight per box
+	std::vector<uint32_t> selectedOccluders;
+	std::vector<size_t> selectedFirstTriangles; //Prefix sum of triangle counts of selected occluders
+
+	std::vector<Triangle> triangles[OCCLUSION_BIN_JOBS]; //Set up by each binning job
+	std::vector<uint32_t> bins[OCCLUSION_BIN_JOBS][TILE_COUNT]; //Indices into triangles of the same job
+	std::vector<float> depthBuffer;
+	float tileFarthest[TILE_COUNT];
+
+	unsigned int occluderCount, triangleCount, rasterizedTriangleCount, testedCount, occludedCount, binJobCount;
+
+	void BinTriangles(unsigned int job, size_t firstTriangle, size_t lastTriangle); //Range of triangles of selected occluders (exclusive end)
+	void BinTriangle(unsigned int job, const glm::vec4& clip0, const glm::vec4& clip1, const glm::vec4& clip2);
+	void RasterizeTiles(int firstTile, int lastTile); //Exclusive end
+	void RasterizeTriangle(const Triangle& triangle, int minX, int minY, int maxX, int maxY);
+	bool IsRectangleVisible(int minX, int minY, int maxX, int maxY, float depth);
+};
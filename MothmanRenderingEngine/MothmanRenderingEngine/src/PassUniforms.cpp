@@ -0,0 +1,53 @@
+#include "PassUniforms.h"
+
+#include "RenderStats.h"
+#include "GLState.h"
+
+PassUniforms::PassUniforms()
+{
+	UBO = 0;
+	slotStride = sizeof(PassBlock);
+}
+
+void PassUniforms::Init()
+{
+	GLint alignment = 1;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment); //Commonly 256 bytes
+	alignment = glm::max(alignment, 1);
+	slotStride = (sizeof(PassBlock) + alignment - 1) / alignment * alignment;
+	data.assign(slotStride * PASS_SLOT_COUNT, 0);
+
+	glGenBuffers(1, &UBO);
+	GLState::BindBuffer(GL_UNIFORM_BUFFER, UBO);
+	glBufferData(GL_UNIFORM_BUFFER, data.size(), nullptr, GL_DYNAMIC_DRAW);
+	GLState::BindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void PassUniforms::SetSlot(int slot, const glm::mat4& projection, const glm::mat4& view)
+{
+	PassBlock* block = (PassBlock*)&data[slot * slotStride];
+	block->projection = projection;
+	block->view = view;
+}
+
+void PassUniforms::Upload()
+{
+	GLState::BindBuffer(GL_UNIFORM_BUFFER, UBO);
+	glBufferData(GL_UNIFORM_BUFFER, data.size(), &data[0], GL_DYNAMIC_DRAW); //Once per frame before the lists run, orphans storage of previous frame (see CommandBuffer.h)
+	RenderStats::Add(RENDER_STAT_BUFFER_UPLOAD_BYTES, data.size());
+	GLState::BindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void PassUniforms::RecordBind(CommandBuffer* commands, int slot)
+{
+	commands->BindUniformBufferRange(PASS_UNIFORMS_UBO_BINDING, UBO, slot * slotStride, sizeof(PassBlock));
+}
+
+PassUniforms::~PassUniforms()
+{
+	if (UBO)
+	{
+		glDeleteBuffers(1, &UBO);
+		GLState::ForgetBuffer(UBO);
+	}
+}
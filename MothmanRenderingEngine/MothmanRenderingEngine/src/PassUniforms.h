@@ -0,0 +1,51 @@
+/*
+Pass uniforms
+
+Uniform buffer with projection and view of passes whose draws are recorded into command buffers (depth pre-pass, directional shadow cascades).
+Shaders read them from PassUniforms block (binding PASS_UNIFORMS_UBO_BINDING). Each pass has its own slot starting at a multiple of
+GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT and its command list binds the range of the slot, so the list carries its camera with it and doesn't need
+uniforms set by the pass function. Recording only needs buffer name and slot offset, main thread fills all slots and uploads them
+once per frame before any list is executed.
+*/
+
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+#include <GL\glew.h>
+#include <glm\glm.hpp>
+
+#include "CommonValues.h"
+#include "CommandBuffer.h"
+
+enum PassUniformSlot
+{
+	PASS_SLOT_DEPTH,
+	PASS_SLOT_CASCADE, //First of MAX_SHADOW_CASCADES slots
+	PASS_SLOT_COUNT = PASS_SLOT_CASCADE + MAX_SHADOW_CASCADES
+};
+
+class PassUniforms
+{
+public:
+	PassUniforms();
+
+	void Init();
+	void SetSlot(int slot, const glm::mat4& projection, const glm::mat4& view);
+	void Upload(); //Main thread, before lists that bind the slots are executed
+	void RecordBind(CommandBuffer* commands, int slot); //Any thread after Init
+
+	~PassUniforms();
+
+private:
+	struct PassBlock //std140 layout of PassUniforms uniform block
+	{
+		glm::mat4 projection;
+		glm::mat4 view;
+	};
+
+	GLuint UBO;
+	GLuint slotStride; //sizeof(PassBlock) rounded up to uniform buffer offset alignment
+	std::vector<uint8_t> data; //CPU copy of all slots
+};
@@ -0,0 +1,147 @@
+#include "PostProcessCompiler.h"
+
+const PostProcessCompiler::EffectInfo PostProcessCompiler::effectInfos[POSTPROCESS_EFFECT_COUNT] =
+{
+	{ "res/Shaders/PostProcessing/invert_postprocess_snippet.shader", "Invert" },
+	{ "res/Shaders/PostProcessing/grayscale_postprocess_snippet.shader", "Grayscale" },
+	{ "res/Shaders/PostProcessing/colorcorrection_postprocess_snippet.shader", "ColorCorrection" },
+	{ "res/Shaders/PostProcessing/vignette_postprocess_snippet.shader", "Vignette" },
+	{ "res/Shaders/PostProcessing/logooverlay_postprocess_snippet.shader", "LogoOverlay" }
+};
+
+PostProcessCompiler::PostProcessCompiler()
+{
+
+}
+
+Shader* PostProcessCompiler::GetShader(const std::vector<PostProcessEffect>& effects)
+{
+	if (effects.empty())
+	{
+		return nullptr;
+	}
+
+	unsigned int key = GetKey(effects);
+	std::unordered_map<unsigned int, Shader*>::const_iterator shader = shaders.find(key);
+	if (shader != shaders.end())
+	{
+		return shader->second;
+	}
+
+	Shader* fusedShader = Compile(effects);
+	shaders[key] = fusedShader;
+	return fusedShader;
+}
+
+unsigned int PostProcessCompiler::GetKey(const std::vector<PostProcessEffect>& effects) //Three bits per effect (effect + 1), so different order gives different key
+{
+	unsigned int key = 0;
+	for (size_t i = 0; i < effects.size(); i++)
+	{
+		key = (key << 3) | (unsigned int)(effects[i] + 1);
+	}
+	return key;
+}
+
+Shader* PostProcessCompiler::Compile(const std::vector<PostProcessEffect>& effects)
+{
+	Shader reader;
+	if (templateCode.empty())
+	{
+		vertexCode = reader.ReadFile("res/Shaders/screen_vertex.shader");
+		templateCode = reader.ReadFile("res/Shaders/PostProcessing/fused_postprocess_fragment.shader");
+	}
+
+	std::string functions;
+	std::string calls;
+	std::string name = "Fused PostProcess Shader (";
+	bool used[POSTPROCESS_EFFECT_COUNT] = {};
+	for (size_t i = 0; i < effects.size(); i++)
+	{
+		PostProcessEffect effect = effects[i];
+		if (!used[effect]) //Effect can be applied more than once, but its function is defined only once
+		{
+			if (snippetCodes[effect].empty())
+			{
+				snippetCodes[effect] = reader.ReadFile(effectInfos[effect].snippetLocation);
+			}
+			functions += snippetCodes[effect] + "\n";
+			used[effect] = true;
+		}
+		calls += std::string("color = ") + effectInfos[effect].functionName + "(color);\n\t";
+		name += std::string(i > 0 ? ", " : "") + effectInfos[effect].functionName;
+	}
+	name += ")";
+
+	std::string fragmentCode = templateCode;
+	if (!ReplaceMarker(fragmentCode, "//EFFECT_FUNCTIONS", functions) || !ReplaceMarker(fragmentCode, "//EFFECT_CALLS", calls))
+	{
+		printf("ERROR: Fused post-processing template is missing effect markers\n");
+	}
+
+	Shader* shader = new Shader(name);
+	shader->CreateFromString(vertexCode.c_str(), fragmentCode.c_str());
+	shader->RegisterSampler("sampler2D", "s_screenTexture");
+	shader->RegisterUniform("vec2", "u_uvScale");
+	for (int i = 0; i < POSTPROCESS_EFFECT_COUNT; i++)
+	{
+		if (used[i])
+		{
+			RegisterEffectUniforms(shader, (PostProcessEffect)i);
+		}
+	}
+
+	printf("LOG: Compiled %s\n", name.c_str());
+	return shader;
+}
+
+void PostProcessCompiler::RegisterEffectUniforms(Shader* shader, PostProcessEffect effect)
+{
+	switch (effect)
+	{
+	case POSTPROCESS_COLOR_CORRECTION:
+		shader->RegisterUniform("float", "u_gamma");
+		shader->RegisterUniform("vec4", "u_tint");
+		break;
+	case POSTPROCESS_VIGNETTE:
+		shader->RegisterUniform("vec2", "u_resolution");
+		shader->RegisterUniform("float", "u_radius");
+		shader->RegisterUniform("float", "u_softness");
+		shader->RegisterUniform("float", "u_intensity");
+		break;
+	case POSTPROCESS_LOGO_OVERLAY:
+		shader->RegisterSampler("sampler2D", "s_logoOverlayTexture");
+		shader->RegisterUniform("vec4", "u_logoOverlayTint");
+		shader->RegisterUniform("vec2", "u_framebufferDimensions");
+		shader->RegisterUniform("vec2", "u_logoOverlayTextureDimensions");
+		break;
+	default: //Invert and grayscale have no uniforms
+		break;
+	}
+}
+
+bool PostProcessCompiler::ReplaceMarker(std::string& code, const std::string& marker, const std::string& replacement)
+{
+	size_t position = code.find(marker);
+	if (position == std::string::npos)
+	{
+		return false;
+	}
+
+	code.replace(position, marker.length(), replacement);
+	return true;
+}
+
+void PostProcessCompiler::ClearShaders()
+{
+	for (std::unordered_map<unsigned int, Shader*>::iterator shader = shaders.begin(); shader != shaders.end(); shader++)
+	{
+		delete shader->second;
+	}
+	shaders.clear();
+}
+
+PostProcessCompiler::~PostProcessCompiler()
+{
+	ClearShaders();
+}
@@ -0,0 +1,52 @@
+/*
+Post-process compiler
+
+Every per-pixel effect used to be separate full-screen pass, so each of them read and wrote whole frame.
+Compiler takes ordered list of enabled per-pixel effects and generates one fragment shader which applies all of them
+after single read of the screen texture (snippets of effects are pasted into fused_postprocess_fragment.shader template).
+Generated shaders are cached by enabled set (and order), so shader is compiled only first time combination is used.
+
+Neighborhood effects (edge detection, SSAO) read other pixels of the input and stay separate passes.
+*/
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+#include <GL\glew.h>
+
+#include "Shader.h"
+#include "PostProcessingEffectsSettings.h"
+
+class PostProcessCompiler
+{
+public:
+	PostProcessCompiler();
+
+	Shader* GetShader(const std::vector<PostProcessEffect>& effects); //Fused shader for effects (compiled on first use), nullptr when list is empty
+	unsigned int GetShaderCount() { return (unsigned int)shaders.size(); }
+	void ClearShaders();
+
+	~PostProcessCompiler();
+
+private:
+	struct EffectInfo
+	{
+		const char* snippetLocation;
+		const char* functionName;
+	};
+
+	static const EffectInfo effectInfos[POSTPROCESS_EFFECT_COUNT];
+
+	std::unordered_map<unsigned int, Shader*> shaders;
+	std::string vertexCode;
+	std::string templateCode;
+	std::string snippetCodes[POSTPROCESS_EFFECT_COUNT];
+
+	static unsigned int GetKey(const std::vector<PostProcessEffect>& effects);
+	Shader* Compile(const std::vector<PostProcessEffect>& effects);
+	void RegisterEffectUniforms(Shader* shader, PostProcessEffect effect);
+	static bool ReplaceMarker(std::string& code, const std::string& marker, const std::string& replacement);
+};
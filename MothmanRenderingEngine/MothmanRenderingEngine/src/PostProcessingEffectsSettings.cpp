@@ -14,6 +14,21 @@ PostProcessingEffectsSettings::PostProcessingEffectsSettings()
 	depthVisualize = DepthVisualize();
 }
 
+void PostProcessingEffectsSettings::GetPerPixelEffects(std::vector<PostProcessEffect>& beforeEdgeDetection, std::vector<PostProcessEffect>& afterEdgeDetection)
+{
+	beforeEdgeDetection.clear();
+	afterEdgeDetection.clear();
+
+	if (invert.IsEnabled()) { beforeEdgeDetection.push_back(POSTPROCESS_INVERT); }
+	if (grayscale.IsEnabled()) { beforeEdgeDetection.push_back(POSTPROCESS_GRAYSCALE); }
+
+	//Without edge detection there is nothing to split, everything goes into one pass
+	std::vector<PostProcessEffect>& effects = edgeDetection.IsEnabled() ? afterEdgeDetection : beforeEdgeDetection;
+	if (colorCorrection.IsEnabled()) { effects.push_back(POSTPROCESS_COLOR_CORRECTION); }
+	if (vignette.IsEnabled()) { effects.push_back(POSTPROCESS_VIGNETTE); }
+	if (logoOverlay.IsEnabled()) { effects.push_back(POSTPROCESS_LOGO_OVERLAY); }
+}
+
 PostProcessingEffectsSettings::~PostProcessingEffectsSettings()
 {
 
@@ -7,10 +7,27 @@ Adding new postprocess:
 - Enable postprocess in main()
 - Add postprocess pass to main() loop
 - Add new effect to ImGui window
+
+Per-pixel effects (output pixel depends only on the same input pixel) are not separate passes:
+- Put function "vec4 EffectName(vec4 color)" with its uniforms into snippet file in Shaders/PostProcessing folder
+- Add effect to PostProcessEffect enum and GetPerPixelEffects()
+- Add snippet, function name and uniforms to PostProcessCompiler, set uniforms in fused pass in main program file
 */
 
 #pragma once
 
+#include <vector>
+
+enum PostProcessEffect //Per-pixel effects that PostProcessCompiler can fuse into one pass
+{
+	POSTPROCESS_INVERT,
+	POSTPROCESS_GRAYSCALE,
+	POSTPROCESS_COLOR_CORRECTION,
+	POSTPROCESS_VIGNETTE,
+	POSTPROCESS_LOGO_OVERLAY,
+	POSTPROCESS_EFFECT_COUNT
+};
+
 struct PostProcessingEffectSettings
 {
 public:
@@ -25,9 +42,22 @@ private:
 struct SSAO : PostProcessingEffectSettings
 {
 public:
-
+	int GetSampleCount() { return sampleCount; }
+	void SetSampleCount(int value) { sampleCount = value; }
+	float GetRadius() { return radius; }
+	void SetRadius(float value) { radius = value; }
+	float GetBias() { return bias; }
+	void SetBias(float value) { bias = value; }
+	int GetResolutionDivisor() { return resolutionDivisor; }
+	void SetResolutionDivisor(int value) { resolutionDivisor = value; }
+	bool IsBlurEnabled() { return blur; }
+	void SetBlur(bool value) { blur = value; }
 private:
-
+	int sampleCount = 16;
+	float radius = 0.5f;
+	float bias = 0.025f;
+	int resolutionDivisor = 2; //Occlusion is computed at half (2) or quarter (4) resolution
+	bool blur = true;
 };
 
 struct Invert : PostProcessingEffectSettings 
@@ -59,9 +89,13 @@ private:
 struct ColorCorrection : PostProcessingEffectSettings
 {
 public:
-
+	float GetGamma() { return gamma; }
+	void SetGamma(float value) { gamma = value; }
+	float* GetTint() { return tint; }
+	void SetTint(float r, float g, float b) { tint[0] = r; tint[1] = g; tint[2] = b; }
 private:
-
+	float gamma = 1.0f;
+	float tint[3] = { 1.0f, 1.0f, 1.0f };
 };
 
 struct Vignette : PostProcessingEffectSettings
@@ -109,6 +143,9 @@ public:
 	void Enable() { enabled = true; }
 	void Disable() { enabled = false; }
 
+	//Enabled per-pixel effects in the order they are applied, split by edge detection (neighborhood effect, has to stay separate pass)
+	void GetPerPixelEffects(std::vector<PostProcessEffect>& beforeEdgeDetection, std::vector<PostProcessEffect>& afterEdgeDetection);
+
 	Invert invert;
 	Grayscale grayscale;
 	EdgeDetection edgeDetection;
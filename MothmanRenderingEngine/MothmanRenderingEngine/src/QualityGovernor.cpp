@@ -0,0 +1,206 @@
+#include "QualityGovernor.h"
+
+static const float RENDER_SCALES[] = { 1.0f, 0.85f, 0.75f, 0.6f, 0.5f };
+static const int SHADOW_RESOLUTION_LEVELS = 3; //Full, half and quarter
+static const float SSAO_SAMPLE_SCALES[] = { 1.0f, 0.75f, 0.5f, 0.25f };
+static const float TERRAIN_DETAIL_SCALES[] = { 1.0f, 0.75f, 0.5f };
+
+QualityGovernor::QualityGovernor()
+{
+	for (int i = 0; i < QUALITY_KNOB_COUNT; i++)
+	{
+		knobs[i].level = 0;
+		knobs[i].active = true;
+		knobs[i].cost = 0.0f;
+	}
+	enabled = false;
+	targetFrameTime = 1000.0f / 60.0f;
+	frameTime = 0.0f;
+	overBudgetFrames = 0;
+	underBudgetFrames = 0;
+	cooldownFrames = 0;
+}
+
+void QualityGovernor::Update(FrameTimer* timer)
+{
+	frameTime = glm::max(timer->GetFrameCPUTime(), timer->GetFrameGPUTime());
+	UpdateKnobCosts(timer);
+	if (!enabled)
+	{
+		return;
+	}
+
+	if (cooldownFrames > 0) //Smoothed times still contain frames from before the last change
+	{
+		cooldownFrames--;
+		return;
+	}
+
+	overBudgetFrames = frameTime > targetFrameTime * QUALITY_GOVERNOR_DEGRADE_THRESHOLD ? overBudgetFrames + 1 : 0;
+	underBudgetFrames = frameTime < targetFrameTime * QUALITY_GOVERNOR_UPGRADE_THRESHOLD ? underBudgetFrames + 1 : 0;
+
+	bool changed = false;
+	if (overBudgetFrames >= QUALITY_GOVERNOR_DEGRADE_FRAMES)
+	{
+		changed = Lower();
+	}
+	else if (underBudgetFrames >= QUALITY_GOVERNOR_UPGRADE_FRAMES)
+	{
+		changed = Raise();
+	}
+
+	if (changed)
+	{
+		overBudgetFrames = 0;
+		underBudgetFrames = 0;
+		cooldownFrames = QUALITY_GOVERNOR_COOLDOWN_FRAMES;
+	}
+}
+
+void QualityGovernor::SetEnabled(bool value)
+{
+	if (enabled == value)
+	{
+		return;
+	}
+	enabled = value;
+	overBudgetFrames = 0;
+	underBudgetFrames = 0;
+	cooldownFrames = 0;
+
+	if (!enabled)
+	{
+		while (!loweredKnobs.empty())
+		{
+			QualityKnob knob = loweredKnobs.back();
+			loweredKnobs.pop_back();
+			SetLevel(knob, 0, "governor disabled");
+		}
+	}
+}
+
+void QualityGovernor::AddKnobSection(QualityKnob knob, const std::string& section)
+{
+	knobs[knob].sections.push_back(section);
+}
+
+const char* QualityGovernor::GetKnobName(QualityKnob knob)
+{
+	switch (knob)
+	{
+	case QUALITY_RENDER_SCALE: return "render scale";
+	case QUALITY_SHADOW_RESOLUTION: return "shadow resolution";
+	case QUALITY_SSAO_SAMPLES: return "SSAO samples";
+	case QUALITY_TERRAIN_DETAIL: return "terrain detail";
+	default: return "unknown";
+	}
+}
+
+int QualityGovernor::GetLevelCount(QualityKnob knob)
+{
+	switch (knob)
+	{
+	case QUALITY_RENDER_SCALE: return sizeof(RENDER_SCALES) / sizeof(RENDER_SCALES[0]);
+	case QUALITY_SHADOW_RESOLUTION: return SHADOW_RESOLUTION_LEVELS;
+	case QUALITY_SSAO_SAMPLES: return sizeof(SSAO_SAMPLE_SCALES) / sizeof(SSAO_SAMPLE_SCALES[0]);
+	case QUALITY_TERRAIN_DETAIL: return sizeof(TERRAIN_DETAIL_SCALES) / sizeof(TERRAIN_DETAIL_SCALES[0]);
+	default: return 1;
+	}
+}
+
+float QualityGovernor::GetRenderScale()
+{
+	return RENDER_SCALES[knobs[QUALITY_RENDER_SCALE].level];
+}
+
+float QualityGovernor::GetSSAOSampleScale()
+{
+	return SSAO_SAMPLE_SCALES[knobs[QUALITY_SSAO_SAMPLES].level];
+}
+
+float QualityGovernor::GetTerrainDetailScale()
+{
+	return TERRAIN_DETAIL_SCALES[knobs[QUALITY_TERRAIN_DETAIL].level];
+}
+
+void QualityGovernor::UpdateKnobCosts(FrameTimer* timer)
+{
+	for (int i = 0; i < QUALITY_KNOB_COUNT; i++)
+	{
+		knobs[i].cost = 0.0f;
+		for (size_t s = 0; s < knobs[i].sections.size(); s++)
+		{
+			const std::string& section = knobs[i].sections[s];
+			knobs[i].cost += glm::max(timer->GetCPUTime(section), timer->GetGPUTime(section));
+		}
+	}
+}
+
+bool QualityGovernor::Lower() //Lower the most expensive knob that can still go lower
+{
+	int chosen = -1;
+	for (int i = 0; i < QUALITY_KNOB_COUNT; i++)
+	{
+		if (!knobs[i].active || knobs[i].level + 1 >= GetLevelCount((QualityKnob)i))
+		{
+			continue;
+		}
+		if (chosen < 0 || knobs[i].cost > knobs[chosen].cost)
+		{
+			chosen = i;
+		}
+	}
+
+	if (chosen < 0)
+	{
+		return false; //Everything is at the lowest level, nothing more to do
+	}
+
+	char reason[128];
+	snprintf(reason, sizeof(reason), "frame %.1f ms over %.1f ms budget, %s costs %.1f ms", frameTime, targetFrameTime, GetKnobName((QualityKnob)chosen), knobs[chosen].cost);
+	loweredKnobs.push_back((QualityKnob)chosen);
+	SetLevel((QualityKnob)chosen, knobs[chosen].level + 1, reason);
+	return true;
+}
+
+bool QualityGovernor::Raise() //Undo the last lowering
+{
+	if (loweredKnobs.empty())
+	{
+		return false;
+	}
+
+	QualityKnob knob = loweredKnobs.back();
+	loweredKnobs.pop_back();
+
+	char reason[128];
+	snprintf(reason, sizeof(reason), "frame %.1f ms leaves headroom in %.1f ms budget", frameTime, targetFrameTime);
+	SetLevel(knob, knobs[knob].level - 1, reason);
+	return true;
+}
+
+void QualityGovernor::SetLevel(QualityKnob knob, int level, const char* reason)
+{
+	std::string from = GetLevelDescription(knob, knobs[knob].level);
+	knobs[knob].level = level;
+	lastChange = std::string(GetKnobName(knob)) + " " + from + " -> " + GetLevelDescription(knob, level) + " (" + reason + ")";
+	printf("LOG: Quality governor: %s\n", lastChange.c_str());
+}
+
+std::string QualityGovernor::GetLevelDescription(QualityKnob knob, int level)
+{
+	char description[32];
+	switch (knob)
+	{
+	case QUALITY_RENDER_SCALE: snprintf(description, sizeof(description), "%.2f", RENDER_SCALES[level]); break;
+	case QUALITY_SHADOW_RESOLUTION: snprintf(description, sizeof(description), "1/%d", 1 << level); break;
+	case QUALITY_SSAO_SAMPLES: snprintf(description, sizeof(description), "%.2f", SSAO_SAMPLE_SCALES[level]); break;
+	case QUALITY_TERRAIN_DETAIL: snprintf(description, sizeof(description), "%.2f", TERRAIN_DETAIL_SCALES[level]); break;
+	default: snprintf(description, sizeof(description), "%d", level); break;
+	}
+	return description;
+}
+
+QualityGovernor::~QualityGovernor()
+{
+}
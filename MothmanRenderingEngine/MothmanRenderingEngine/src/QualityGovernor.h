@@ -0,0 +1,90 @@
+/*
+Quality governor
+
+Holds frame time (max of CPU and GPU time measured by FrameTimer) at target budget by lowering and raising quality knobs one step at a time:
+- render scale: render graph extent is this part of the framebuffer, ScreenPass upscales to the window
+- shadow resolution: directional shadow map and point/spot light atlas tiles are halved per level
+- SSAO samples: part of the sample count set by the user
+- terrain detail: part of terrain tessellation factor and lod ranges
+Hysteresis: quality is lowered after QUALITY_GOVERNOR_DEGRADE_FRAMES frames over budget * QUALITY_GOVERNOR_DEGRADE_THRESHOLD,
+raised after QUALITY_GOVERNOR_UPGRADE_FRAMES frames under budget * QUALITY_GOVERNOR_UPGRADE_THRESHOLD (the gap keeps it from oscillating)
+and nothing is evaluated for QUALITY_GOVERNOR_COOLDOWN_FRAMES frames after each change.
+Lowered knob is the one whose timer sections cost most, raised knob is the one lowered last.
+Knobs of disabled features are inactive (never lowered). Every change is logged with its reason.
+Levels don't modify user settings, users of the knobs apply them on top of their own settings (Get*Scale).
+*/
+
+#pragma once
+
+#include <stdio.h>
+#include <vector>
+#include <string>
+
+#include <glm\glm.hpp>
+
+#include "CommonValues.h"
+#include "FrameTimer.h"
+
+enum QualityKnob
+{
+	QUALITY_RENDER_SCALE,
+	QUALITY_SHADOW_RESOLUTION,
+	QUALITY_SSAO_SAMPLES,
+	QUALITY_TERRAIN_DETAIL,
+	QUALITY_KNOB_COUNT
+};
+
+class QualityGovernor
+{
+public:
+	QualityGovernor();
+
+	void Update(FrameTimer* timer); //Once per frame, after timer collected results of old frames
+
+	bool IsEnabled() { return enabled; }
+	void SetEnabled(bool value); //Disabling restores full quality
+	float GetTargetFrameTime() { return targetFrameTime; }
+	void SetTargetFrameTime(float value) { targetFrameTime = glm::max(value, 1.0f); }
+
+	void AddKnobSection(QualityKnob knob, const std::string& section); //Frame timer section whose cost the knob reduces
+	void SetKnobActive(QualityKnob knob, bool value) { knobs[knob].active = value; }
+	bool IsKnobActive(QualityKnob knob) { return knobs[knob].active; }
+
+	const char* GetKnobName(QualityKnob knob);
+	int GetLevel(QualityKnob knob) { return knobs[knob].level; } //0 is full quality
+	int GetLevelCount(QualityKnob knob);
+	float GetKnobCost(QualityKnob knob) { return knobs[knob].cost; } //Milliseconds spent in knob sections last update
+
+	float GetRenderScale();
+	int GetShadowResolutionShift() { return knobs[QUALITY_SHADOW_RESOLUTION].level; } //Shadow sizes are divided by 2^shift
+	float GetSSAOSampleScale();
+	float GetTerrainDetailScale();
+
+	float GetFrameTime() { return frameTime; }
+	const std::string& GetLastChange() { return lastChange; }
+
+	~QualityGovernor();
+
+private:
+	struct Knob
+	{
+		std::vector<std::string> sections;
+		int level;
+		bool active;
+		float cost;
+	};
+
+	Knob knobs[QUALITY_KNOB_COUNT];
+	std::vector<QualityKnob> loweredKnobs; //Stack, raised in reverse order
+	bool enabled;
+	float targetFrameTime; //Milliseconds
+	float frameTime;
+	int overBudgetFrames, underBudgetFrames, cooldownFrames;
+	std::string lastChange;
+
+	void UpdateKnobCosts(FrameTimer* timer);
+	bool Lower();
+	bool Raise();
+	void SetLevel(QualityKnob knob, int level, const char* reason);
+	std::string GetLevelDescription(QualityKnob knob, int level);
+};
@@ -0,0 +1,412 @@
+#include "RenderGraph.h"
+
+#include "GLState.h"
+
+RenderGraph::RenderGraph()
+{
+	screenSize = glm::uvec2(0);
+	extent = glm::uvec2(0);
+	bucket = glm::uvec2(0);
+	pendingSize = glm::uvec2(0);
+	stableFrames = 0;
+	frame = 0;
+	culledPassCount = 0;
+	timer = nullptr;
+	screenFramebuffer = 0;
+}
+
+bool RenderGraph::BeginFrame(GLuint screenWidth, GLuint screenHeight, float renderScale)
+{
+	frame++;
+	passes.clear();
+	resources.clear();
+	culledPassCount = 0;
+	DeleteUnusedTextures();
+
+	screenSize = glm::uvec2(screenWidth, screenHeight);
+	if (screenWidth == 0 || screenHeight == 0) //Minimized, keep rendering in old extent
+	{
+		return false;
+	}
+
+	glm::uvec2 renderSize = glm::max(glm::uvec2(glm::vec2(screenSize) * renderScale + 0.5f), glm::uvec2(1));
+	if (renderSize != pendingSize)
+	{
+		pendingSize = renderSize;
+		stableFrames = 0;
+	}
+	else
+	{
+		stableFrames++;
+	}
+
+	glm::uvec2 sizeBucket = glm::uvec2(RoundToBucket(renderSize.x), RoundToBucket(renderSize.y));
+	if (sizeBucket != bucket && (stableFrames >= RENDER_GRAPH_RESIZE_DEBOUNCE || extent.x == 0))
+	{
+		bucket = sizeBucket;
+	}
+
+	if (renderSize != extent && renderSize.x <= bucket.x && renderSize.y <= bucket.y)
+	{
+		extent = renderSize;
+		return true;
+	}
+	return false;
+}
+
+RenderResource RenderGraph::CreateTexture(const std::string& name, GLenum internalFormat, GLuint divisor, GLenum filter)
+{
+	Resource resource;
+	resource.name = name;
+	resource.internalFormat = internalFormat;
+	resource.divisor = glm::max(divisor, 1u);
+	resource.filter = filter;
+	resource.firstPass = -1;
+	resource.lastPass = -1;
+	resource.texture = -1;
+	resources.push_back(resource);
+	return (RenderResource)resources.size() - 1;
+}
+
+int RenderGraph::AddPass(const std::string& name, std::function<void()> execute)
+{
+	Pass pass;
+	pass.name = name;
+	pass.execute = execute;
+	pass.sideEffect = false;
+	pass.culled = false;
+	passes.push_back(pass);
+	return (int)passes.size() - 1;
+}
+
+void RenderGraph::Read(int pass, RenderResource resource)
+{
+	passes[pass].reads.push_back(resource);
+}
+
+void RenderGraph::Write(int pass, RenderResource resource)
+{
+	passes[pass].writes.push_back(resource);
+}
+
+void RenderGraph::SetSideEffect(int pass)
+{
+	passes[pass].sideEffect = true;
+}
+
+void RenderGraph::Compile()
+{
+	//Culling, from the last pass to the first
+	std::vector<bool> required(resources.size(), false);
+	for (int i = (int)passes.size() - 1; i >= 0; i--)
+	{
+		Pass& pass = passes[i];
+		bool needed = pass.sideEffect;
+		for (size_t w = 0; w < pass.writes.size() && !needed; w++)
+		{
+			needed = required[pass.writes[w]];
+		}
+
+		pass.culled = !needed;
+		if (pass.culled)
+		{
+			culledPassCount++;
+			continue;
+		}
+
+		for (size_t r = 0; r < pass.reads.size(); r++)
+		{
+			required[pass.reads[r]] = true;
+		}
+	}
+
+	//Lifetimes
+	for (int i = 0; i < (int)passes.size(); i++)
+	{
+		if (passes[i].culled)
+		{
+			continue;
+		}
+
+		for (int list = 0; list < 2; list++)
+		{
+			const std::vector<RenderResource>& used = list == 0 ? passes[i].reads : passes[i].writes;
+			for (size_t u = 0; u < used.size(); u++)
+			{
+				Resource& resource = resources[used[u]];
+				if (resource.firstPass < 0) { resource.firstPass = i; }
+				resource.lastPass = i;
+			}
+		}
+	}
+
+	//Pooled textures, returned to the pool after the last pass using them, so following resources can alias them
+	for (size_t t = 0; t < pool.size(); t++)
+	{
+		pool[t].inUse = false;
+	}
+	for (int i = 0; i < (int)passes.size(); i++)
+	{
+		for (size_t r = 0; r < resources.size(); r++)
+		{
+			if (resources[r].firstPass == i)
+			{
+				resources[r].texture = AcquireTexture(resources[r]);
+			}
+		}
+		for (size_t r = 0; r < resources.size(); r++)
+		{
+			if (resources[r].lastPass == i)
+			{
+				pool[resources[r].texture].inUse = false;
+			}
+		}
+	}
+}
+
+int RenderGraph::AcquireTexture(const Resource& resource)
+{
+	glm::uvec2 size = GetTextureSize(resource);
+	for (size_t t = 0; t < pool.size(); t++)
+	{
+		PooledTexture& pooled = pool[t];
+		if (!pooled.inUse && pooled.internalFormat == resource.internalFormat && pooled.width == size.x && pooled.height == size.y)
+		{
+			pooled.inUse = true;
+			pooled.lastUsedFrame = frame;
+			return (int)t;
+		}
+	}
+
+	GLenum format, type;
+	unsigned int bytesPerPixel;
+	GetFormatInfo(resource.internalFormat, format, type, bytesPerPixel);
+
+	PooledTexture pooled;
+	pooled.internalFormat = resource.internalFormat;
+	pooled.width = size.x;
+	pooled.height = size.y;
+	pooled.inUse = true;
+	pooled.lastUsedFrame = frame;
+
+	glGenTextures(1, &pooled.texture);
+	GLState::BindTexture(GL_TEXTURE_2D, pooled.texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, resource.internalFormat, size.x, size.y, 0, format, type, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	GLState::BindTexture(GL_TEXTURE_2D, 0);
+
+	printf("LOG: Render graph allocated %ux%u texture for %s\n", size.x, size.y, resource.name.c_str());
+	pool.push_back(pooled);
+	return (int)pool.size() - 1;
+}
+
+void RenderGraph::Execute()
+{
+	for (size_t i = 0; i < passes.size(); i++)
+	{
+		const Pass& pass = passes[i];
+		if (pass.culled)
+		{
+			continue;
+		}
+
+		//Same texture can be aliased by resources with different filtering
+		for (int list = 0; list < 2; list++)
+		{
+			const std::vector<RenderResource>& used = list == 0 ? pass.reads : pass.writes;
+			for (size_t u = 0; u < used.size(); u++)
+			{
+				const Resource& resource = resources[used[u]];
+				if (resource.firstPass == (int)i)
+				{
+					GLState::BindTexture(GL_TEXTURE_2D, pool[resource.texture].texture);
+					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, resource.filter);
+					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, resource.filter);
+				}
+			}
+		}
+
+		if (timer != nullptr) { timer->Begin(pass.name); }
+		BindPassTargets(pass);
+		pass.execute();
+		if (timer != nullptr) { timer->End(); }
+	}
+
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, screenFramebuffer);
+	GLState::Viewport(0, 0, screenSize.x, screenSize.y);
+}
+
+void RenderGraph::BindPassTargets(const Pass& pass)
+{
+	if (pass.writes.empty())
+	{
+		GLState::BindFramebuffer(GL_FRAMEBUFFER, screenFramebuffer);
+		GLState::Viewport(0, 0, screenSize.x, screenSize.y);
+		return;
+	}
+
+	std::vector<GLuint> attachments;
+	GLuint depthTexture = 0;
+	for (size_t w = 0; w < pass.writes.size(); w++)
+	{
+		const Resource& resource = resources[pass.writes[w]];
+		if (IsDepthFormat(resource.internalFormat))
+		{
+			depthTexture = pool[resource.texture].texture;
+		}
+		else
+		{
+			attachments.push_back(pool[resource.texture].texture);
+		}
+	}
+	size_t colorCount = attachments.size();
+	if (depthTexture)
+	{
+		attachments.push_back(depthTexture);
+	}
+
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, GetFramebuffer(attachments, colorCount));
+	glm::uvec2 size = GetExtent(pass.writes[0]);
+	GLState::Viewport(0, 0, size.x, size.y);
+}
+
+GLuint RenderGraph::GetFramebuffer(const std::vector<GLuint>& attachments, size_t colorCount)
+{
+	std::map<std::vector<GLuint>, GLuint>::const_iterator cached = framebuffers.find(attachments);
+	if (cached != framebuffers.end())
+	{
+		return cached->second;
+	}
+
+	GLuint framebuffer;
+	glGenFramebuffers(1, &framebuffer);
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+	GLenum drawBuffers[8];
+	for (size_t i = 0; i < colorCount && i < 8; i++)
+	{
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + (GLenum)i, GL_TEXTURE_2D, attachments[i], 0);
+		drawBuffers[i] = GL_COLOR_ATTACHMENT0 + (GLenum)i;
+	}
+	if (attachments.size() > colorCount)
+	{
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, attachments[colorCount], 0);
+	}
+
+	if (colorCount > 0)
+	{
+		glDrawBuffers((GLsizei)colorCount, drawBuffers);
+	}
+	else
+	{
+		glDrawBuffer(GL_NONE);
+		glReadBuffer(GL_NONE);
+	}
+
+	GLenum Status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	if (Status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		printf("Framebuffer error: %i\n", Status);
+	}
+
+	framebuffers[attachments] = framebuffer;
+	return framebuffer;
+}
+
+glm::vec2 RenderGraph::GetUVScale(RenderResource resource)
+{
+	return glm::vec2(GetExtent(resource)) / glm::vec2(GetTextureSize(resources[resource]));
+}
+
+glm::uvec2 RenderGraph::GetExtent(RenderResource resource)
+{
+	return glm::max(extent / resources[resource].divisor, glm::uvec2(1));
+}
+
+size_t RenderGraph::GetPooledMemory()
+{
+	size_t memory = 0;
+	for (size_t t = 0; t < pool.size(); t++)
+	{
+		GLenum format, type;
+		unsigned int bytesPerPixel;
+		GetFormatInfo(pool[t].internalFormat, format, type, bytesPerPixel);
+		memory += (size_t)pool[t].width * pool[t].height * bytesPerPixel;
+	}
+	return memory;
+}
+
+void RenderGraph::DeleteUnusedTextures()
+{
+	for (size_t t = 0; t < pool.size();)
+	{
+		if (frame - pool[t].lastUsedFrame <= RENDER_GRAPH_POOL_LIFETIME)
+		{
+			t++;
+			continue;
+		}
+
+		GLuint texture = pool[t].texture;
+		for (std::map<std::vector<GLuint>, GLuint>::iterator framebuffer = framebuffers.begin(); framebuffer != framebuffers.end();)
+		{
+			if (std::find(framebuffer->first.begin(), framebuffer->first.end(), texture) != framebuffer->first.end())
+			{
+				glDeleteFramebuffers(1, &framebuffer->second);
+				GLState::ForgetFramebuffer(framebuffer->second);
+				framebuffer = framebuffers.erase(framebuffer);
+			}
+			else
+			{
+				framebuffer++;
+			}
+		}
+
+		glDeleteTextures(1, &texture);
+		GLState::ForgetTexture(texture);
+		pool.erase(pool.begin() + t);
+	}
+}
+
+void RenderGraph::GetFormatInfo(GLenum internalFormat, GLenum& format, GLenum& type, unsigned int& bytesPerPixel)
+{
+	switch (internalFormat)
+	{
+	case GL_RGB8: format = GL_RGB; type = GL_UNSIGNED_BYTE; bytesPerPixel = 4; break; //Drivers pad RGB8 to four bytes
+	case GL_RGBA8: format = GL_RGBA; type = GL_UNSIGNED_BYTE; bytesPerPixel = 4; break;
+	case GL_RG16F: format = GL_RG; type = GL_FLOAT; bytesPerPixel = 4; break;
+	case GL_RGB16F: format = GL_RGB; type = GL_FLOAT; bytesPerPixel = 8; break;
+	case GL_RGBA16F: format = GL_RGBA; type = GL_FLOAT; bytesPerPixel = 8; break;
+	case GL_DEPTH_COMPONENT16: format = GL_DEPTH_COMPONENT; type = GL_UNSIGNED_SHORT; bytesPerPixel = 2; break;
+	case GL_DEPTH_COMPONENT24: format = GL_DEPTH_COMPONENT; type = GL_UNSIGNED_INT; bytesPerPixel = 4; break;
+	case GL_DEPTH_COMPONENT32F: format = GL_DEPTH_COMPONENT; type = GL_FLOAT; bytesPerPixel = 4; break;
+	default:
+		printf("ERROR: Render graph doesn't know texture format %u\n", internalFormat);
+		format = GL_RGBA; type = GL_UNSIGNED_BYTE; bytesPerPixel = 4;
+		break;
+	}
+}
+
+void RenderGraph::ReleaseTextures()
+{
+	for (std::map<std::vector<GLuint>, GLuint>::iterator framebuffer = framebuffers.begin(); framebuffer != framebuffers.end(); framebuffer++)
+	{
+		glDeleteFramebuffers(1, &framebuffer->second);
+		GLState::ForgetFramebuffer(framebuffer->second);
+	}
+	framebuffers.clear();
+
+	for (size_t t = 0; t < pool.size(); t++)
+	{
+		glDeleteTextures(1, &pool[t].texture);
+		GLState::ForgetTexture(pool[t].texture);
+	}
+	pool.clear();
+	resources.clear();
+	passes.clear();
+}
+
+RenderGraph::~RenderGraph()
+{
+	ReleaseTextures();
+}
@@ -0,0 +1,126 @@
+/*
+Render graph
+
+Every frame passes are declared in execution order together with textures they read and write, then graph is compiled and executed.
+- Culling: going backwards from passes with side effects (writing outside of the graph, e.g. to the screen), pass is kept only
+  when kept pass reads something it writes. Disabled features cost nothing (depth pre-pass runs only when SSAO or depth visualize reads it).
+- Transient textures: texture declared in the graph lives from first to last kept pass that uses it. Physical texture is taken from a pool
+  when lifetime starts and returned when it ends, so textures with the same format and size whose lifetimes don't overlap are aliased
+  (post-processing chain ends up ping-ponging between two textures without knowing about it).
+- Resize: pooled textures are rounded up to RENDER_GRAPH_SIZE_BUCKET, passes render into extent (screen size) in their corner.
+  Resize that fits into current textures only changes extent. Bucket changes only after size is stable for RENDER_GRAPH_RESIZE_DEBOUNCE frames
+  (until then frame is rendered in old extent and stretched to the window), so dragging window edge doesn't reallocate every frame.
+  Pooled textures not used for RENDER_GRAPH_POOL_LIFETIME frames are deleted.
+  Render scale makes extent smaller than the screen (pass rendering to the screen upscales). Lowering it fits into current textures,
+  so it changes only extent.
+  Shaders sampling graph textures scale texture coordinates by GetUVScale (u_uvScale in screen_vertex.shader).
+Framebuffers are created for every combination of attachments and cached until one of their textures is deleted.
+With a timer set, CPU and GPU time of every executed pass is measured.
+*/
+
+#pragma once
+
+#include <stdio.h>
+#include <vector>
+#include <string>
+#include <map>
+#include <functional>
+#include <algorithm>
+
+#include <GL\glew.h>
+#include <glm\glm.hpp>
+
+#include "CommonValues.h"
+#include "FrameTimer.h"
+
+typedef int RenderResource; //Handle of texture declared in the graph, valid for one frame
+
+class RenderGraph
+{
+public:
+	RenderGraph();
+
+	bool BeginFrame(GLuint screenWidth, GLuint screenHeight, float renderScale = 1.0f); //Forget passes of last frame and apply resize, returns true when extent changed
+
+	RenderResource CreateTexture(const std::string& name, GLenum internalFormat, GLuint divisor = 1, GLenum filter = GL_LINEAR); //Size is extent / divisor
+	int AddPass(const std::string& name, std::function<void()> execute);
+	void Read(int pass, RenderResource resource);
+	void Write(int pass, RenderResource resource); //Color or depth attachment (by format), bound together with viewport before pass executes
+	void SetSideEffect(int pass); //Pass is never culled, pass without attachments renders to the screen
+	void SetScreenFramebuffer(GLuint value) { screenFramebuffer = value; } //Framebuffer used as the screen (default framebuffer when 0, headless mode renders offscreen)
+
+	void Compile(); //Cull passes, compute lifetimes and assign pooled textures
+	void Execute();
+	void SetTimer(FrameTimer* value) { timer = value; } //Every executed pass is timed as a section named after the pass
+
+	GLuint GetTexture(RenderResource resource) { return pool[resources[resource].texture].texture; } //Only while executing passes using the resource
+	glm::vec2 GetUVScale(RenderResource resource); //Part of the texture covered by extent
+	glm::uvec2 GetExtent(RenderResource resource);
+	glm::uvec2 GetExtent() { return extent; }
+
+	unsigned int GetPassCount() { return (unsigned int)passes.size(); }
+	const std::string& GetPassName(int pass) { return passes[pass].name; }
+	bool IsPassCulled(int pass) { return passes[pass].culled; }
+	unsigned int GetCulledPassCount() { return culledPassCount; }
+	unsigned int GetResourceCount() { return (unsigned int)resources.size(); }
+	unsigned int GetPooledTextureCount() { return (unsigned int)pool.size(); }
+	size_t GetPooledMemory(); //In bytes
+
+	void ReleaseTextures(); //Delete all pooled textures and framebuffers
+
+	~RenderGraph();
+
+private:
+	struct Resource
+	{
+		std::string name;
+		GLenum internalFormat;
+		GLuint divisor;
+		GLenum filter;
+		int firstPass, lastPass; //Kept passes using the resource (-1 when unused)
+		int texture; //Index in pool
+	};
+
+	struct Pass
+	{
+		std::string name;
+		std::function<void()> execute;
+		std::vector<RenderResource> reads;
+		std::vector<RenderResource> writes;
+		bool sideEffect;
+		bool culled;
+	};
+
+	struct PooledTexture
+	{
+		GLuint texture;
+		GLenum internalFormat;
+		GLuint width, height;
+		bool inUse;
+		unsigned int lastUsedFrame;
+	};
+
+	std::vector<Resource> resources;
+	std::vector<Pass> passes;
+	std::vector<PooledTexture> pool;
+	std::map<std::vector<GLuint>, GLuint> framebuffers; //Attachments (colors, then depth) -> framebuffer
+
+	glm::uvec2 screenSize;
+	glm::uvec2 extent, bucket;
+	glm::uvec2 pendingSize; //Requested extent waiting for debounce
+	unsigned int stableFrames;
+	unsigned int frame;
+	unsigned int culledPassCount;
+	FrameTimer* timer;
+	GLuint screenFramebuffer;
+
+	int AcquireTexture(const Resource& resource);
+	void BindPassTargets(const Pass& pass);
+	GLuint GetFramebuffer(const std::vector<GLuint>& attachments, size_t colorCount);
+	void DeleteUnusedTextures();
+	glm::uvec2 GetTextureSize(const Resource& resource) { return glm::max(bucket / resource.divisor, glm::uvec2(1)); }
+
+	static GLuint RoundToBucket(GLuint size) { return (size + RENDER_GRAPH_SIZE_BUCKET - 1) / RENDER_GRAPH_SIZE_BUCKET * RENDER_GRAPH_SIZE_BUCKET; }
+	static bool IsDepthFormat(GLenum internalFormat) { return internalFormat == GL_DEPTH_COMPONENT16 || internalFormat == GL_DEPTH_COMPONENT24 || internalFormat == GL_DEPTH_COMPONENT32F; }
+	static void GetFormatInfo(GLenum internalFormat, GLenum& format, GLenum& type, unsigned int& bytesPerPixel);
+};
@@ -0,0 +1,300 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "JobSystem.h"
+
+static const float SORT_DEPTH_RANGE = 256.0f; //Distances further than this share the last depth bucket
+static const size_t CULL_PACKETS_PER_JOB = 2048; //Smaller queues are culled on calling thread
+
+RenderQueue::RenderQueue()
+{
+}
+
+void RenderQueue::Clear()
+{
+	packets.clear();
+	boundsCenterX.clear();
+	boundsCenterY.clear();
+	boundsCenterZ.clear();
+	boundsRadius.clear();
+}
+
+void RenderQueue::Submit(Mesh* mesh, Material* material, Texture* diffuseTexture, Texture* normalTexture, const glm::mat4& transform, unsigned int flags)
+{
+	DrawPacket packet;
+	packet.mesh = mesh;
+	packet.material = material;
+	packet.diffuseTexture = diffuseTexture;
+	packet.normalTexture = normalTexture;
+	packet.transform = transform;
+	packet.flags = flags;
+	packets.push_back(packet);
+
+	glm::vec3 center = glm::vec3(transform * glm::vec4(mesh->GetBoundingSphereCenter(), 1.0f));
+	float scale = glm::max(glm::length(glm::vec3(transform[0])), glm::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])))); //Largest axis scale keeps sphere conservative
+	boundsCenterX.push_back(center.x);
+	boundsCenterY.push_back(center.y);
+	boundsCenterZ.push_back(center.z);
+	boundsRadius.push_back(mesh->GetBoundingSphereRadius() * scale);
+}
+
+void RenderQueue::CullFrustum(const Frustum& frustum, std::vector<uint32_t>& visiblePackets, CullScratch& scratch)
+{
+	visiblePackets.clear();
+	if (packets.empty()) { return; }
+
+	if (packets.size() <= CULL_PACKETS_PER_JOB)
+	{
+		Culling::CullSpheresByPlanes(frustum.GetPlanes(), 6, &boundsCenterX[0], &boundsCenterY[0], &boundsCenterZ[0], &boundsRadius[0], packets.size(), visiblePackets);
+	}
+	else //Every job culls its own range into its own list, lists are joined in order so result is the same as on one thread
+	{
+		size_t chunkCount = (packets.size() + CULL_PACKETS_PER_JOB - 1) / CULL_PACKETS_PER_JOB;
+		std::vector<std::vector<uint32_t>>& cullChunks = scratch.chunks;
+		if (cullChunks.size() < chunkCount) { cullChunks.resize(chunkCount); }
+		JobSystem::ParallelFor("Frustum culling", packets.size(), CULL_PACKETS_PER_JOB, [this, &frustum, &cullChunks](size_t first, size_t last)
+		{
+			std::vector<uint32_t>& chunk = cullChunks[first / CULL_PACKETS_PER_JOB];
+			chunk.clear();
+			Culling::CullSpheresByPlanes(frustum.GetPlanes(), 6, &boundsCenterX[first], &boundsCenterY[first], &boundsCenterZ[first], &boundsRadius[first], last - first, chunk);
+			for (size_t i = 0; i < chunk.size(); i++) { chunk[i] += (uint32_t)first; }
+		});
+		for (size_t i = 0; i < chunkCount; i++)
+		{
+			visiblePackets.insert(visiblePackets.end(), cullChunks[i].begin(), cullChunks[i].end());
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(statsMutex);
+	stats.visible += visiblePackets.size();
+	stats.culled += packets.size() - visiblePackets.size();
+}
+
+void RenderQueue::CullSphere(const glm::vec3& center, float radius, std::vector<uint32_t>& visiblePackets)
+{
+	visiblePackets.clear();
+	if (packets.empty()) { return; }
+
+	Culling::CullSpheresBySphere(center, radius, &boundsCenterX[0], &boundsCenterY[0], &boundsCenterZ[0], &boundsRadius[0], packets.size(), visiblePackets);
+
+	std::lock_guard<std::mutex> lock(statsMutex);
+	stats.visible += visiblePackets.size();
+	stats.culled += packets.size() - visiblePackets.size();
+}
+
+void RenderQueue::CullOcclusion(OcclusionCuller* occlusionCuller, std::vector<uint32_t>& visiblePackets)
+{
+	size_t kept = 0;
+	for (size_t i = 0; i < visiblePackets.size(); i++)
+	{
+		Mesh* mesh = packets[visiblePackets[i]].mesh;
+		bool hasBounds = boundsRadius[visiblePackets[i]] != std::numeric_limits<float>::infinity();
+		if (!hasBounds || occlusionCuller->IsVisible(mesh->GetAABBMin(), mesh->GetAABBMax(), packets[visiblePackets[i]].transform))
+		{
+			visiblePackets[kept++] = visiblePackets[i];
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(statsMutex);
+		stats.occluded += visiblePackets.size() - kept;
+	}
+	visiblePackets.resize(kept);
+}
+
+void RenderQueue::SubmitModel(Model* model, Material* material, const glm::mat4& transform, unsigned int flags)
+{
+	for (size_t i = 0; i < model->GetMeshCount(); i++)
+	{
+		Submit(model->GetMesh(i), material, model->GetMeshTexture(i, TexType::Diffuse), model->GetMeshTexture(i, TexType::Normal), transform, flags);
+	}
+}
+
+uint64_t RenderQueue::CalculateSortKey(const DrawPacket& packet, GLuint programID, const glm::vec3& viewPosition, bool useMaterials)
+{
+	uint64_t key = 0;
+	key |= (uint64_t)(programID & 0xFF) << 56;
+
+	if (useMaterials)
+	{
+		GLuint materialID = packet.material != nullptr ? packet.material->GetMaterialID() : 0;
+		GLuint textureID = packet.diffuseTexture != nullptr ? packet.diffuseTexture->GetTextureID() : 0;
+		key |= (uint64_t)(materialID & 0xFFF) << 44;
+		key |= (uint64_t)(textureID & 0xFFF) << 32;
+	}
+
+	key |= (uint64_t)(packet.mesh->GetVAO() & 0xFFFF) << 16;
+
+	float distance = glm::length(glm::vec3(packet.transform[3]) - viewPosition); //Distance to object origin is enough for ordering
+	float depth = glm::clamp(distance / SORT_DEPTH_RANGE, 0.0f, 1.0f);
+	key |= (uint64_t)(depth * 65535.0f); //Front-to-back
+
+	return key;
+}
+
+void RenderQueue::DetectChanges(const RenderQueue* previous)
+{
+	changedBounds.clear();
+
+	size_t previousCount = previous != nullptr ? previous->packets.size() : 0;
+	size_t count = glm::max(packets.size(), previousCount);
+	for (size_t i = 0; i < count; i++)
+	{
+		bool castsNow = i < packets.size() && (packets[i].flags & DRAW_FLAG_CAST_SHADOWS);
+		bool castedBefore = i < previousCount && (previous->packets[i].flags & DRAW_FLAG_CAST_SHADOWS);
+		if (!castsNow && !castedBefore) { continue; }
+
+		if (castsNow && castedBefore && packets[i].mesh == previous->packets[i].mesh && packets[i].transform == previous->packets[i].transform) { continue; } //Same caster in the same place
+
+		if (castedBefore) { changedBounds.push_back(previous->GetBounds(i)); } //Shadow has to disappear from old position
+		if (castsNow) { changedBounds.push_back(GetBounds(i)); }
+	}
+}
+
+bool RenderQueue::HasChangesInFrustum(const Frustum& frustum)
+{
+	for (size_t i = 0; i < changedBounds.size(); i++)
+	{
+		if (frustum.IntersectsSphere(glm::vec3(changedBounds[i]), changedBounds[i].w)) { return true; }
+	}
+	return false;
+}
+
+bool RenderQueue::HasChangesInSphere(const glm::vec3& center, float radius)
+{
+	for (size_t i = 0; i < changedBounds.size(); i++)
+	{
+		glm::vec3 offset = glm::vec3(changedBounds[i]) - center;
+		float radiusSum = changedBounds[i].w + radius;
+		if (glm::dot(offset, offset) <= radiusSum * radiusSum) { return true; }
+	}
+	return false;
+}
+
+bool RenderQueue::CanBatch(const DrawPacket& first, const DrawPacket& packet, bool useMaterials)
+{
+	if (packet.mesh != first.mesh) { return false; }
+	if (!useMaterials) { return true; } //Depth only passes do not care about material and textures
+
+	return packet.material == first.material && packet.diffuseTexture == first.diffuseTexture && packet.normalTexture == first.normalTexture;
+}
+
+void RenderQueue::Record(CommandBuffer* commands, Shader* shader, const glm::vec3& viewPosition, unsigned int requiredFlags, bool useMaterials, const std::vector<uint32_t>& visiblePackets)
+{
+	if (visiblePackets.empty()) { return; }
+
+	SortItem* sortItems = commands->AllocateScratch<SortItem>(visiblePackets.size());
+	size_t itemCount = 0;
+	for (size_t i = 0; i < visiblePackets.size(); i++)
+	{
+		const DrawPacket& packet = packets[visiblePackets[i]];
+		if ((packet.flags & requiredFlags) != requiredFlags) { continue; }
+
+		sortItems[itemCount].key = CalculateSortKey(packet, shader->GetShaderID(), viewPosition, useMaterials);
+		sortItems[itemCount].packetIndex = visiblePackets[i];
+		itemCount++;
+	}
+
+	if (itemCount == 0) { return; }
+
+	std::sort(sortItems, sortItems + itemCount, [](const SortItem& a, const SortItem& b) { return a.key < b.key; });
+
+	commands->BindProgram(shader->GetShaderID()); //Pass function may have used it for its uniforms already, then the bind is filtered by GLState
+
+	GLint specularIntensityLocation = -1, shininessLocation = -1;
+	if (useMaterials)
+	{
+		specularIntensityLocation = shader->GetUniformLocation("u_material.specularIntensity");
+		shininessLocation = shader->GetUniformLocation("u_material.shininess");
+	}
+
+	//Model matrices of the whole pass in sort order, every batch draws a range of them
+	glm::mat4* instanceTransforms = commands->InstanceData((uint32_t)itemCount);
+	for (size_t i = 0; i < itemCount; i++)
+	{
+		instanceTransforms[i] = packets[sortItems[i].packetIndex].transform;
+	}
+
+	//Merge consecutive packets into batches, sort key keeps packets with the same state next to each other
+	RenderQueueStats passStats;
+	Mesh* lastMesh = nullptr;
+	Material* lastMaterial = nullptr;
+	Texture* lastDiffuseTexture = nullptr;
+	Texture* lastNormalTexture = nullptr;
+
+	size_t batchBegin = 0;
+	while (batchBegin < itemCount)
+	{
+		const DrawPacket& packet = packets[sortItems[batchBegin].packetIndex];
+		size_t batchEnd = batchBegin + 1;
+		while (batchEnd < itemCount && CanBatch(packet, packets[sortItems[batchEnd].packetIndex], useMaterials)) { batchEnd++; }
+
+		if (useMaterials)
+		{
+			if (packet.material != lastMaterial && packet.material != nullptr)
+			{
+				commands->SetUniform(specularIntensityLocation, packet.material->GetSpecularIntensity());
+				commands->SetUniform(shininessLocation, packet.material->GetShininess());
+				lastMaterial = packet.material;
+				passStats.materialChanges++;
+			}
+			if (packet.diffuseTexture != lastDiffuseTexture && packet.diffuseTexture != nullptr && packet.diffuseTexture->GetTextureUnit() >= 0)
+			{
+				commands->BindTexture(packet.diffuseTexture->GetTextureUnit(), GL_TEXTURE_2D, packet.diffuseTexture->GetTextureID());
+				lastDiffuseTexture = packet.diffuseTexture;
+				passStats.textureBinds++;
+			}
+			if (packet.normalTexture != lastNormalTexture && packet.normalTexture != nullptr && packet.normalTexture->GetTextureUnit() >= 0)
+			{
+				commands->BindTexture(packet.normalTexture->GetTextureUnit(), GL_TEXTURE_2D, packet.normalTexture->GetTextureID());
+				lastNormalTexture = packet.normalTexture;
+				passStats.textureBinds++;
+			}
+		}
+
+		if (packet.mesh != lastMesh)
+		{
+			commands->BindVertexArray(packet.mesh->GetVAO());
+			lastMesh = packet.mesh;
+			passStats.meshBinds++;
+		}
+
+		commands->DrawIndexedInstanced(packet.mesh->GetIndexCount(), (GLsizei)batchBegin, (GLsizei)(batchEnd - batchBegin));
+		passStats.drawCalls++;
+		passStats.instances += batchEnd - batchBegin;
+		batchBegin = batchEnd;
+	}
+
+	std::lock_guard<std::mutex> lock(statsMutex);
+	stats.drawCalls += passStats.drawCalls;
+	stats.instances += passStats.instances;
+	stats.meshBinds += passStats.meshBinds;
+	stats.materialChanges += passStats.materialChanges;
+	stats.textureBinds += passStats.textureBinds;
+}
+
+void RenderQueue::Render(Shader* shader, const glm::vec3& viewPosition, unsigned int requiredFlags, bool useMaterials, const std::vector<uint32_t>& visiblePackets)
+{
+	immediateCommands.Begin();
+	Record(&immediateCommands, shader, viewPosition, requiredFlags, useMaterials, visiblePackets);
+	immediateCommands.End();
+	immediateCommands.Execute();
+}
+
+RenderQueueStats RenderQueue::GetStats()
+{
+	std::lock_guard<std::mutex> lock(statsMutex);
+	return stats;
+}
+
+void RenderQueue::ResetStats()
+{
+	std::lock_guard<std::mutex> lock(statsMutex);
+	stats = RenderQueueStats();
+}
+
+RenderQueue::~RenderQueue()
+{
+}
@@ -0,0 +1,139 @@
+/*
+Render queue
+
+Scene submits draw packets once per frame (mesh, material, textures, transform, flags) instead of drawing models directly.
+Each pass sorts packets with a 64-bit key and draws them issuing only state changes that differ between consecutive packets.
+
+Sort key layout (most significant bits first):
+| program (8) | material (12) | diffuse texture (12) | mesh (16) | depth (16) |
+
+Passes that do not use materials (shadow and depth passes) leave material and texture bits empty, so packets are grouped by mesh only.
+Depth is quantized distance from the pass view position, opaque geometry is sorted front-to-back.
+
+Every draw is instanced. After sorting, consecutive packets that share mesh (and material and textures in passes that use them) are merged into one batch,
+their model matrices are written contiguously into an instance buffer uploaded once per pass, and each batch is a single glDrawElementsInstanced.
+Shaders read the model matrix from vertex attribute INSTANCE_TRANSFORM_LOCATION instead of a uniform.
+
+Passes are recorded into command buffers (CommandBuffer) instead of calling GL: Record sorts and batches the packets and writes instance data,
+binds and draws, main thread replays the buffer inside the pass. Record doesn't need OpenGL context, so jobs record passes of the frame
+in parallel (each into its own command buffer). Render records into a buffer of the queue and replays it right away (main thread only).
+
+World space bounding sphere of every packet is calculated at submit and stored as structure of arrays for SIMD culling.
+Each pass first culls packets against its volume (camera or light frustum, point light sphere of influence) into a list of visible packets,
+then renders only those. Camera list is calculated once and shared by depth and main pass, after frustum culling packets hidden behind occluders
+are removed from it by software occlusion culling (OcclusionCuller, local AABB of the mesh is tested with packet transform).
+Frustum culling of big queues is split between jobs (JobSystem::ParallelFor). Queue is filled by one thread at a time:
+every frame packet (FramePipeline) has its own queue, simulation jobs fill it and build camera list, after that the queue is only read,
+so shadow passes can be culled and passes recorded by several jobs at once (stats are guarded by a mutex).
+Culling and recording only update stats of the queue, RenderStats are added by render thread (counts land in the frame rendered).
+
+Shadow caching: after submit, shadow casting packets are compared with queue of previous frame (by submission order) and bounds of every caster that
+moved, appeared or disappeared (both old and new position) are collected. Shadow map of a light that did not change itself is re-rendered only
+if one of these bounds intersects its volume.
+*/
+
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <stdint.h>
+
+#include <GL\glew.h>
+#include <glm\glm.hpp>
+#include <glm\gtc\type_ptr.hpp>
+
+#include "Mesh.h"
+#include "Model.h"
+#include "Material.h"
+#include "Texture.h"
+#include "Shader.h"
+#include "Frustum.h"
+#include "Culling.h"
+#include "OcclusionCuller.h"
+#include "CommandBuffer.h"
+
+enum DrawFlags
+{
+	DRAW_FLAG_NONE = 0,
+	DRAW_FLAG_OPAQUE = 1 << 0,
+	DRAW_FLAG_CAST_SHADOWS = 1 << 1,
+	DRAW_FLAG_OCCLUDER = 1 << 2, //Mesh is drawn into occlusion culling depth buffer (if it has occluder geometry)
+};
+
+struct DrawPacket
+{
+	Mesh* mesh;
+	Material* material;
+	Texture* diffuseTexture;
+	Texture* normalTexture;
+	glm::mat4 transform;
+	unsigned int flags;
+};
+
+struct CullScratch //Per-job results of frustum culling split between jobs, owned by whoever culls so concurrent culls share nothing and reuse memory
+{
+	std::vector<std::vector<uint32_t>> chunks;
+};
+
+struct RenderQueueStats
+{
+	unsigned int drawCalls = 0;
+	unsigned int instances = 0; //Packets drawn, drawCalls is smaller when packets were merged into instanced batches
+	unsigned int meshBinds = 0;
+	unsigned int materialChanges = 0;
+	unsigned int textureBinds = 0;
+	unsigned int visible = 0; //Packets that passed culling (sum of all passes)
+	unsigned int culled = 0; //Packets rejected by culling (sum of all passes)
+	unsigned int occluded = 0; //Camera visible packets removed by occlusion culling
+};
+
+class RenderQueue
+{
+public:
+	RenderQueue();
+
+	void Clear(); //Remove all packets, called at the beginning of each frame
+	void Submit(Mesh* mesh, Material* material, Texture* diffuseTexture, Texture* normalTexture, const glm::mat4& transform, unsigned int flags);
+	void SubmitModel(Model* model, Material* material, const glm::mat4& transform, unsigned int flags); //Submit one packet for each mesh of the model
+	void DetectChanges(const RenderQueue* previous); //Compare shadow casters with queue of previous frame (nullptr if none), call once after whole scene is submitted
+
+	//Whether any shadow caster changed inside the volume since previous frame
+	bool HasChangesInFrustum(const Frustum& frustum);
+	bool HasChangesInSphere(const glm::vec3& center, float radius);
+
+	//Fill visiblePackets with indices of packets whose bounds intersect the volume
+	void CullFrustum(const Frustum& frustum, std::vector<uint32_t>& visiblePackets, CullScratch& scratch);
+	void CullSphere(const glm::vec3& center, float radius, std::vector<uint32_t>& visiblePackets);
+	void CullOcclusion(OcclusionCuller* occlusionCuller, std::vector<uint32_t>& visiblePackets); //Remove packets hidden in already rasterized occlusion buffer
+
+	//Sort visible packets for given pass and record their draws into commands (between Begin and End of the buffer). Packets without all of requiredFlags are skipped.
+	//Shader is only read (program ID, material uniform locations), commands bind its program. Any thread, commands are not shared
+	void Record(CommandBuffer* commands, Shader* shader, const glm::vec3& viewPosition, unsigned int requiredFlags, bool useMaterials, const std::vector<uint32_t>& visiblePackets);
+	//Record and execute right away, main thread only
+	void Render(Shader* shader, const glm::vec3& viewPosition, unsigned int requiredFlags, bool useMaterials, const std::vector<uint32_t>& visiblePackets);
+
+	const std::vector<DrawPacket>& GetPackets() { return packets; }
+	RenderQueueStats GetStats();
+	void ResetStats();
+
+	~RenderQueue();
+
+private:
+	struct SortItem
+	{
+		uint64_t key;
+		uint32_t packetIndex;
+	};
+
+	std::vector<DrawPacket> packets;
+	std::vector<float> boundsCenterX, boundsCenterY, boundsCenterZ, boundsRadius; //World space bounding sphere of each packet
+
+	std::vector<glm::vec4> changedBounds; //Bounds of shadow casters changed in this frame
+	CommandBuffer immediateCommands; //Used by Render
+	RenderQueueStats stats;
+	std::mutex statsMutex; //Culling and recording of different passes run in parallel
+
+	uint64_t CalculateSortKey(const DrawPacket& packet, GLuint programID, const glm::vec3& viewPosition, bool useMaterials);
+	bool CanBatch(const DrawPacket& first, const DrawPacket& packet, bool useMaterials); //Whether packet can be drawn as another instance of batch started by first
+	glm::vec4 GetBounds(size_t packetIndex) const { return glm::vec4(boundsCenterX[packetIndex], boundsCenterY[packetIndex], boundsCenterZ[packetIndex], boundsRadius[packetIndex]); }
+};
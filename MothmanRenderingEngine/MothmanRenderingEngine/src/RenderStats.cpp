@@ -0,0 +1,55 @@
+#include "RenderStats.h"
+
+RenderStatValues RenderStats::totals = {};
+
+void RenderStats::Reset()
+{
+	for (int i = 0; i < RENDER_STAT_COUNT; i++)
+	{
+		totals.values[i] = 0;
+	}
+}
+
+const char* RenderStats::GetStatName(RenderStat stat)
+{
+	switch (stat)
+	{
+	case RENDER_STAT_DRAW_CALLS: return "Draw calls";
+	case RENDER_STAT_TRIANGLES: return "Triangles";
+	case RENDER_STAT_UNIFORM_CALLS: return "Uniform calls";
+	case RENDER_STAT_PROGRAM_BINDS: return "Program binds";
+	case RENDER_STAT_TEXTURE_BINDS: return "Texture binds";
+	case RENDER_STAT_VAO_BINDS: return "VAO binds";
+	case RENDER_STAT_FRAMEBUFFER_BINDS: return "Framebuffer binds";
+	case RENDER_STAT_STATE_CHANGES: return "Other state changes";
+	case RENDER_STAT_REDUNDANT_STATE: return "Redundant state (skipped)";
+	case RENDER_STAT_BUFFER_UPLOAD_BYTES: return "Buffer upload bytes";
+	case RENDER_STAT_TEXTURE_UPLOAD_BYTES: return "Texture upload bytes";
+	case RENDER_STAT_OBJECTS_DRAWN: return "Objects drawn";
+	case RENDER_STAT_OBJECTS_CULLED: return "Objects culled";
+	case RENDER_STAT_OBJECTS_OCCLUDED: return "Objects occluded";
+	default: return "Unknown";
+	}
+}
+
+const char* RenderStats::GetStatKey(RenderStat stat)
+{
+	switch (stat)
+	{
+	case RENDER_STAT_DRAW_CALLS: return "draw_calls";
+	case RENDER_STAT_TRIANGLES: return "triangles";
+	case RENDER_STAT_UNIFORM_CALLS: return "uniform_calls";
+	case RENDER_STAT_PROGRAM_BINDS: return "program_binds";
+	case RENDER_STAT_TEXTURE_BINDS: return "texture_binds";
+	case RENDER_STAT_VAO_BINDS: return "vao_binds";
+	case RENDER_STAT_FRAMEBUFFER_BINDS: return "framebuffer_binds";
+	case RENDER_STAT_STATE_CHANGES: return "state_changes";
+	case RENDER_STAT_REDUNDANT_STATE: return "redundant_state";
+	case RENDER_STAT_BUFFER_UPLOAD_BYTES: return "buffer_upload_bytes";
+	case RENDER_STAT_TEXTURE_UPLOAD_BYTES: return "texture_upload_bytes";
+	case RENDER_STAT_OBJECTS_DRAWN: return "objects_drawn";
+	case RENDER_STAT_OBJECTS_CULLED: return "objects_culled";
+	case RENDER_STAT_OBJECTS_OCCLUDED: return "objects_occluded";
+	default: return "unknown";
+	}
+}
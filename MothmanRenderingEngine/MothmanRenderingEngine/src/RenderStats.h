@@ -0,0 +1,57 @@
+/*
+Render stats
+
+Counters of OpenGL work, incremented next to the GL calls themselves (Mesh, Texture, Shader, PatchVBO, terrain, render graph, shadow atlas, passes):
+draw calls, triangles submitted, glUniform* calls, program, texture, VAO and framebuffer binds, bytes uploaded into buffers and textures,
+and objects drawn and culled (render queue packets that passed or failed culling, once per culling pass), objects occluded
+(camera packets that passed frustum culling, so they are counted as drawn too, and were then removed by occlusion culling).
+Binds and other state changes (enable bits, masks, viewport, buffer binds, active texture) are counted by GLState when they reach the driver,
+calls GLState filtered out as redundant are counted separately.
+Counters are plain running totals (classes with GL calls have no access to the renderer), reset by FrameTimer::BeginFrame.
+Per frame and per pass values are differences of the totals taken by the frame timer at Begin/End of its sections (FrameTimer::GetSectionStat),
+so stats of a pass include stats of sections nested in it, the same way its time does.
+Tessellated terrain patches count as draw calls, triangles produced by tessellation are not known on CPU and are not counted.
+*/
+
+#pragma once
+
+enum RenderStat
+{
+	RENDER_STAT_DRAW_CALLS,
+	RENDER_STAT_TRIANGLES,
+	RENDER_STAT_UNIFORM_CALLS,
+	RENDER_STAT_PROGRAM_BINDS,
+	RENDER_STAT_TEXTURE_BINDS,
+	RENDER_STAT_VAO_BINDS,
+	RENDER_STAT_FRAMEBUFFER_BINDS,
+	RENDER_STAT_STATE_CHANGES,
+	RENDER_STAT_REDUNDANT_STATE,
+	RENDER_STAT_BUFFER_UPLOAD_BYTES,
+	RENDER_STAT_TEXTURE_UPLOAD_BYTES,
+	RENDER_STAT_OBJECTS_DRAWN,
+	RENDER_STAT_OBJECTS_CULLED,
+	RENDER_STAT_OBJECTS_OCCLUDED,
+	RENDER_STAT_COUNT
+};
+
+struct RenderStatValues
+{
+	unsigned long long values[RENDER_STAT_COUNT];
+};
+
+class RenderStats
+{
+public:
+	static void Add(RenderStat stat, unsigned long long value = 1) { totals.values[stat] += value; }
+	static void AddDraw(unsigned long long triangles) { totals.values[RENDER_STAT_DRAW_CALLS]++; totals.values[RENDER_STAT_TRIANGLES] += triangles; }
+	static void Reset();
+
+	static unsigned long long GetTotal(RenderStat stat) { return totals.values[stat]; }
+	static const RenderStatValues& GetTotals() { return totals; }
+
+	static const char* GetStatName(RenderStat stat); //For GUI
+	static const char* GetStatKey(RenderStat stat); //For reports (CSV column, JSON key)
+
+private:
+	static RenderStatValues totals;
+};
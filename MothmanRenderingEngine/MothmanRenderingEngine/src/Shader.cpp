@@ -1,5 +1,8 @@
 #include "Shader.h"
 
+#include "RenderStats.h"
+#include "GLState.h"
+
 Shader::Shader()
 {
 	this->shaderName = "no shader name provided";
@@ -238,6 +241,7 @@ void Shader::SetUniform(const string& uniformName, int value)
 			return;
 		}
 		glUniform1i(uniform->second.uniformLocation, value);
+		RenderStats::Add(RENDER_STAT_UNIFORM_CALLS);
 	}
 	else
 	{
@@ -257,6 +261,7 @@ void Shader::SetUniform(const string& uniformName, GLuint value)
 			return;
 		}
 		glUniform1i(uniform->second.uniformLocation, value);
+		RenderStats::Add(RENDER_STAT_UNIFORM_CALLS);
 	}
 	else
 	{
@@ -276,6 +281,7 @@ void Shader::SetUniform(const string& uniformName, float value)
 			return;
 		}
 		glUniform1f(uniform->second.uniformLocation, value);
+		RenderStats::Add(RENDER_STAT_UNIFORM_CALLS);
 	}
 	else
 	{
@@ -295,6 +301,7 @@ void Shader::SetUniform(const string& uniformName, float value0, float value1)
 			return;
 		}
 		glUniform2f(uniform->second.uniformLocation, value0, value1);
+		RenderStats::Add(RENDER_STAT_UNIFORM_CALLS);
 	}
 	else
 	{
@@ -314,6 +321,7 @@ void Shader::SetUniform(const string& uniformName, const glm::vec2& value)
 			return;
 		}
 		glUniform2f(uniform->second.uniformLocation, value.x, value.y);
+		RenderStats::Add(RENDER_STAT_UNIFORM_CALLS);
 	}
 	else
 	{
@@ -333,6 +341,7 @@ void Shader::SetUniform(const string& uniformName, float value0, float value1, f
 			return;
 		}
 		glUniform3f(uniform->second.uniformLocation, value0, value1, value2);
+		RenderStats::Add(RENDER_STAT_UNIFORM_CALLS);
 	}
 	else
 	{
@@ -352,6 +361,7 @@ void Shader::SetUniform(const string& uniformName, const glm::vec3& value)
 			return;
 		}
 		glUniform3f(uniform->second.uniformLocation, value.x, value.y, value.z);
+		RenderStats::Add(RENDER_STAT_UNIFORM_CALLS);
 	}
 	else
 	{
@@ -371,6 +381,7 @@ void Shader::SetUniform(const string& uniformName, float value0, float value1, f
 			return;
 		}
 		glUniform4f(uniform->second.uniformLocation, value0, value1, value2, value3);
+		RenderStats::Add(RENDER_STAT_UNIFORM_CALLS);
 	}
 	else
 	{
@@ -390,6 +401,7 @@ void Shader::SetUniform(const string& uniformName, const glm::vec4& value)
 			return;
 		}
 		glUniform4f(uniform->second.uniformLocation, value.x, value.y, value.z, value.w);
+		RenderStats::Add(RENDER_STAT_UNIFORM_CALLS);
 	}
 	else
 	{
@@ -409,6 +421,7 @@ void Shader::SetUniform(const string& uniformName, const glm::mat4& value)
 			return;
 		}
 		glUniformMatrix4fv(uniform->second.uniformLocation, 1, GL_FALSE, glm::value_ptr(value));
+		RenderStats::Add(RENDER_STAT_UNIFORM_CALLS);
 	}
 	else
 	{
@@ -476,35 +489,55 @@ void Shader::SetSampler(const string& samplerName, int value)
 
 	if (sampler != samplers.end())
 	{
-		if (!(sampler->second.samplerType == "sampler2D" || sampler->second.samplerType == "samplerCube"))
+		if (!(sampler->second.samplerType == "sampler2D" || sampler->second.samplerType == "samplerCube" || sampler->second.samplerType == "sampler2DArray" || sampler->second.samplerType == "samplerBuffer" || sampler->second.samplerType == "usamplerBuffer"))
 		{
 			LogShaderError("Failed setting sampler. Invalid sampler type int for: " + samplerName);
 			return;
 		}
 		glUniform1i(sampler->second.samplerLocation, value);
+		RenderStats::Add(RENDER_STAT_UNIFORM_CALLS);
 	}
 	else
 	{
-		LogShaderError("Failed setting sampler. Sampler with name: " + samplerName + " and type: sampler2D or samplerCube, not found");
+		LogShaderError("Failed setting sampler. Sampler with name: " + samplerName + " and type: sampler2D, samplerCube, sampler2DArray, samplerBuffer or usamplerBuffer, not found");
 	}
 }
 
 void Shader::BindSampler(const string& samplerName, GLuint textureUnit, GLuint textureToBind) //Bind texture to provided texture unit, then set sampler in shader to look for texture at texture unit with number textureUnit 
 {
-	glActiveTexture(GL_TEXTURE0 + textureUnit);
 	string samplerType = GetSamplerType(samplerName);
 	if (samplerType == "sampler2D")
 	{
-		glBindTexture(GL_TEXTURE_2D, textureToBind);
+		GLState::BindTexture(textureUnit, GL_TEXTURE_2D, textureToBind);
 	}
 	if (samplerType == "samplerCube")
 	{
-		glBindTexture(GL_TEXTURE_CUBE_MAP, textureToBind);
+		GLState::BindTexture(textureUnit, GL_TEXTURE_CUBE_MAP, textureToBind);
+	}
+	if (samplerType == "sampler2DArray")
+	{
+		GLState::BindTexture(textureUnit, GL_TEXTURE_2D_ARRAY, textureToBind);
+	}
+	if (samplerType == "samplerBuffer" || samplerType == "usamplerBuffer")
+	{
+		GLState::BindTexture(textureUnit, GL_TEXTURE_BUFFER, textureToBind);
 	}
 	SetSampler(samplerName, textureUnit); 
 }
 
 
+bool Shader::BindUniformBlock(const string& blockName, GLuint bindingPoint)
+{
+	GLuint blockIndex = glGetUniformBlockIndex(shaderID, blockName.c_str());
+	if (blockIndex == GL_INVALID_INDEX)
+	{
+		LogShaderError("Failed binding uniform block: " + blockName + ". No such uniform block found in this shader's code");
+		return false;
+	}
+
+	glUniformBlockBinding(shaderID, blockIndex, bindingPoint);
+	return true;
+}
 
 #pragma endregion
 
@@ -531,7 +564,7 @@ void Shader::CompileProgram()
 
 void Shader::UseShader()
 {
-	glUseProgram(shaderID);
+	GLState::UseProgram(shaderID);
 }
 
 void Shader::ClearShader()
@@ -539,6 +572,7 @@ void Shader::ClearShader()
 	if (shaderID != 0)
 	{
 		glDeleteProgram(shaderID);
+		GLState::ForgetProgram(shaderID);
 		shaderID = 0;
 	}
 }
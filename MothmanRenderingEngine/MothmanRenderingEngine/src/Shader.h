@@ -64,6 +64,7 @@ public:
 	void Validate();
 	void UseShader();
 	void ClearShader();
+	GLuint GetShaderID() { return shaderID; }
 
 	//Uniforms
 	bool RegisterUniform(const string& uniformType, const string& uniformName);
@@ -88,6 +89,9 @@ public:
 	void SetSampler(const string& samplerName, int value); //Should not be accessible publicly
 	void BindSampler(const string& samplerName, GLuint textureUnit, GLuint textureToBind);
 
+	//Uniform blocks
+	bool BindUniformBlock(const string& blockName, GLuint bindingPoint); //Connect uniform block to buffer binding point (glBindBufferBase)
+
 	~Shader();
 
 private:
@@ -1,5 +1,7 @@
 #include "Skybox.h"
 
+#include "GLState.h"
+
 
 
 Skybox::Skybox()
@@ -12,7 +14,7 @@ Skybox::Skybox(Shader* skyboxShader, std::vector<std::string> faceLocations)
 
 	// Texture Setup
 	glGenTextures(1, &textureId);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, textureId);
+	GLState::BindTexture(GL_TEXTURE_CUBE_MAP, textureId);
 
 	int width, height, bitDepth;
 
@@ -78,7 +80,7 @@ void Skybox::DrawSkybox(glm::mat4 viewMatrix, glm::mat4 projectionMatrix)
 {
 	viewMatrix = glm::mat4(glm::mat3(viewMatrix));
 
-	glDepthMask(GL_FALSE); //Disable depth mask for skybox rendering, so the cube will look like it is always behind everything
+	GLState::DepthMask(GL_FALSE); //Disable depth mask for skybox rendering, so the cube will look like it is always behind everything
 
 	skyboxShader->UseShader();
 
@@ -86,14 +88,13 @@ void Skybox::DrawSkybox(glm::mat4 viewMatrix, glm::mat4 projectionMatrix)
 	skyboxShader->SetUniform("u_view", viewMatrix);
 
 
-	glActiveTexture(GL_TEXTURE0 + SKYBOX_TEXUNIT);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, textureId);
+	GLState::BindTexture(SKYBOX_TEXUNIT, GL_TEXTURE_CUBE_MAP, textureId);
 
 	skyboxShader->Validate();
 
 	skyboxMesh->RenderMesh();
 
-	glDepthMask(GL_TRUE);
+	GLState::DepthMask(GL_TRUE);
 }
 
 Skybox::~Skybox()
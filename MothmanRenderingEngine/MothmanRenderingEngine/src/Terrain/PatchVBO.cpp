@@ -3,6 +3,9 @@
 #include <stdio.h>
 #include <iostream>
 
+#include "..\RenderStats.h"
+#include "..\GLState.h"
+
 PatchVBO::PatchVBO()
 {
 	VAO = 0;
@@ -12,35 +15,34 @@ PatchVBO::PatchVBO()
 void PatchVBO::Allocate(GLfloat *vertices, unsigned int numOfVertices, unsigned int vertexLength, unsigned int patchSize)
 {
 	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
+	GLState::BindVertexArray(VAO);
 	
 	glGenBuffers(1, &VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO); 
+	GLState::BindBuffer(GL_ARRAY_BUFFER, VBO); 
 	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices[0]) * numOfVertices * 2, vertices, GL_STATIC_DRAW);
+	RenderStats::Add(RENDER_STAT_BUFFER_UPLOAD_BYTES, sizeof(vertices[0]) * numOfVertices * 2);
 	
 
 	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(vertices[0]) * vertexLength, (void*)(sizeof(vertices[0]) * 0));
+	glEnableVertexAttribArray(0); //Enabled attributes are VAO state, no need to enable them for every draw
 	glPatchParameteri(GL_PATCH_VERTICES, patchSize);
 
-	glBindVertexArray(0);
+	GLState::BindVertexArray(0);
 }
 
 void PatchVBO::Draw()
 {
-	glBindVertexArray(VAO);
-	glEnableVertexAttribArray(0);
+	GLState::BindVertexArray(VAO); //All leaves share the same patch, only the first one really binds it
 
 	glDrawArrays(GL_PATCHES, 0, 16);
-
-	glDisableVertexAttribArray(0);
-	glBindVertexArray(0);
+	RenderStats::AddDraw(0); //Triangles come from tessellation
 }
 
 
 PatchVBO::~PatchVBO()
 {
-	glBindVertexArray(VAO);
 	glDeleteBuffers(1, &VBO);
-	glDeleteBuffers(1, &VAO);
-	glBindVertexArray(0);
+	glDeleteVertexArrays(1, &VAO);
+	GLState::ForgetBuffer(VBO);
+	GLState::ForgetVertexArray(VAO);
 }
@@ -1,5 +1,7 @@
 #include "TerrainModule.h"
 
+#include "..\RenderStats.h"
+
 TerrainModule::TerrainModule(TerrainSettings* terrainSettings)
 {
 	this->terrainSettings = terrainSettings;
@@ -18,6 +20,10 @@ void TerrainModule::UpdateTerrain()
 	{
 		cameraPos = terrainSettings->GetCamera()->GetCameraPosition();
 		quadtree->Update();
+
+		std::lock_guard<std::mutex> lock(footprintMutex);
+		leafFootprints.clear();
+		quadtree->GetLeafFootprints(leafFootprints);
 	}
 }
 
@@ -35,6 +41,36 @@ void TerrainModule::Render(bool updateTerrain)
 	quadtree->Render();
 }
 
+void TerrainModule::GetOccluderBoxes(const glm::vec3& cameraPosition, std::vector<glm::vec3>& boxMin, std::vector<glm::vec3>& boxMax)
+{
+	GLfloat scaleXZ = terrainSettings->GetScaleXZ();
+	GLfloat scaleY = terrainSettings->GetScaleY();
+	if (scaleY <= 0.0f)
+	{
+		return;
+	}
+
+	glm::vec2 cameraMap = (glm::vec2(cameraPosition.x, cameraPosition.z) + scaleXZ / 2.0f) / scaleXZ; //Inverse of world matrix
+	if (cameraMap.x < 0.0f || cameraMap.y < 0.0f || cameraMap.x > 1.0f || cameraMap.y > 1.0f || cameraPosition.y <= terrainSettings->GetMaxHeight(cameraMap, cameraMap) * scaleY)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(footprintMutex);
+	for (size_t i = 0; i < leafFootprints.size(); i++)
+	{
+		glm::vec2 mapMin = glm::vec2(leafFootprints[i]);
+		glm::vec2 mapMax = mapMin + leafFootprints[i].z;
+		GLfloat top = terrainSettings->GetMinHeight(mapMin, mapMax) * scaleY;
+		if (top <= 0.0f) //Flat box hides nothing
+		{
+			continue;
+		}
+		boxMin.push_back(glm::vec3(mapMin.x * scaleXZ - scaleXZ / 2.0f, 0.0f, mapMin.y * scaleXZ - scaleXZ / 2.0f));
+		boxMax.push_back(glm::vec3(mapMax.x * scaleXZ - scaleXZ / 2.0f, top, mapMax.y * scaleXZ - scaleXZ / 2.0f));
+	}
+}
+
 void TerrainModule::UpdateShaderVariables() //These are variables common for every leaf so they can be set once per frame for whole terrain
 {
 	glUniformMatrix4fv(terrainSettings->GetTerrainUniform_worldMatrix(), 1, GL_FALSE, glm::value_ptr(worldMatrix));
@@ -49,10 +85,11 @@ void TerrainModule::UpdateShaderVariables() //These are variables common for eve
 
 	glUniformMatrix4fv(terrainSettings->GetTerrainUniform_viewProjection(), 1, GL_FALSE, glm::value_ptr(terrainSettings->GetCamera()->GetProjectionMatrix() * terrainSettings->GetCamera()->GetViewMatrix()));
 
-	glUniform1i(terrainSettings->GetTerrainUniform_tessellationFactor(), terrainSettings->GetTessellationFactor());
+	glUniform1i(terrainSettings->GetTerrainUniform_tessellationFactor(), terrainSettings->GetDetailTessellationFactor());
 	glUniform1f(terrainSettings->GetTerrainUniform_tessellationSlope(), terrainSettings->GetTessellationSlope());
 	glUniform1f(terrainSettings->GetTerrainUniform_tessellationShift(), terrainSettings->GetTessellationShift());
 	glUniform1i(terrainSettings->GetTerrainUniform_textureNormal(), NORMAL_TEXUNIT); //Not necessarily need to be updated for each node
+	RenderStats::Add(RENDER_STAT_UNIFORM_CALLS, 17);
 }
 
 TerrainModule::~TerrainModule()
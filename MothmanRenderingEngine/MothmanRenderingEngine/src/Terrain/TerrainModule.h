@@ -8,10 +8,17 @@ All nodes use same buffer (VBO) on GPU. Each node updates buffer with its own va
 
 Morphing of edges on the transition between lod levels is done by vertex shader.
 
+Occluder boxes: box under the lowest point of a leaf node is hidden below the terrain surface, so whatever the box hides, terrain hides too.
+It holds only when camera looks from above the terrain (line from camera to the box has to cross the surface), otherwise there are no boxes.
+Leaves are copied at the end of each update, boxes are built from the copy under a mutex, so occlusion culling of next frame (simulation job)
+can ask for them while render thread updates the quadtree.
+
 */
 
 #pragma once
 
+#include <mutex>
+
 #include "..\Shader.h"
 #include "..\Camera.h"
 #include "TerrainQuadtree.h"
@@ -25,6 +32,7 @@ public:
 	TerrainModule(TerrainSettings* terrainSettings);
 	void UpdateTerrain();
 	void Render(bool updateTerrain);
+	void GetOccluderBoxes(const glm::vec3& cameraPosition, std::vector<glm::vec3>& boxMin, std::vector<glm::vec3>& boxMax); //World space boxes of current leaves
 
 	~TerrainModule();	
 
@@ -35,5 +43,7 @@ private:
 	glm::vec3 cameraPos;
 	glm::vec3 cameraForward;
 	glm::mat4 worldMatrix;
+	std::vector<glm::vec3> leafFootprints; //Leaves after last update, guarded by footprintMutex
+	std::mutex footprintMutex;
 };
 
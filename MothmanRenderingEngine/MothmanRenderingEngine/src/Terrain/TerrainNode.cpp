@@ -1,5 +1,7 @@
 #include "TerrainNode.h"
 
+#include "..\RenderStats.h"
+
 TerrainNode::TerrainNode(TerrainSettings* terrainSettings, PatchVBO* buffer, glm::vec2 location, int lod, glm::vec2 index)
 {
 	this->terrainSettings = terrainSettings;
@@ -29,6 +31,7 @@ void TerrainNode::Render()
 		glUniform2f(terrainSettings->GetTerrainUniform_index(), index.x, index.y);
 		glUniform1f(terrainSettings->GetTerrainUniform_gap(), gap);
 		glUniform2f(terrainSettings->GetTerrainUniform_location(), location.x, location.y);
+		RenderStats::Add(RENDER_STAT_UNIFORM_CALLS, 5);
 
 		buffer->Draw();
 	}
@@ -72,6 +75,18 @@ void TerrainNode::Update()
 	}	
 }
 
+void TerrainNode::GetLeafFootprints(std::vector<glm::vec3>& footprints)
+{
+	if (isleaf)
+	{
+		footprints.push_back(glm::vec3(location, gap));
+	}
+	for (unsigned int i = 0; i < children.size(); i++)
+	{
+		children[i]->GetLeafFootprints(footprints);
+	}
+}
+
 void TerrainNode::AddChildNodes(int lod)
 {
 
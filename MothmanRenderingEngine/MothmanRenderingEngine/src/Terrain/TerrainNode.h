@@ -17,6 +17,7 @@ public:
 	TerrainNode(TerrainSettings* terrainSettings, PatchVBO* buffer, glm::vec2 location, int lod, glm::vec2 index);
 	void Render();
 	void Update();
+	void GetLeafFootprints(std::vector<glm::vec3>& footprints); //Map space location (x, y) and side length (z) of leaves
 	~TerrainNode();
 
 private:	
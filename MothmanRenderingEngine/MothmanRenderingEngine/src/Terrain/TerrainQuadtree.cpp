@@ -58,6 +58,14 @@ void TerrainQuadtree::Render()
 }
 
 
+void TerrainQuadtree::GetLeafFootprints(std::vector<glm::vec3>& footprints)
+{
+	for (unsigned int i = 0; i < terrainNodes.size(); i++)
+	{
+		terrainNodes[i]->GetLeafFootprints(footprints);
+	}
+}
+
 TerrainQuadtree::~TerrainQuadtree()
 {
 }
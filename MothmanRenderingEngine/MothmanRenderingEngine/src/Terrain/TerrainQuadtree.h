@@ -20,6 +20,7 @@ public:
 
 	void Update();
 	void Render();
+	void GetLeafFootprints(std::vector<glm::vec3>& footprints); //Map space location (x, y) and side length (z) of every leaf node
 
 	~TerrainQuadtree();
 	
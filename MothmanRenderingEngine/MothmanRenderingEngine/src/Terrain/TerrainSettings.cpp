@@ -15,9 +15,11 @@ TerrainSettings::TerrainSettings(const string& terrainName, Shader* terrainShade
 
 	for (int i = 0; i < 8; i++)
 	{
+		this->configuredLodRange[i] = lodRange[i];
 		this->lodRange[i] = lodRange[i];
 		this->lodMorphingArea[i] = 0;
 	}
+	detailScale = 1.0f;
 
 	this->tessellationFactor = tessellationFactor;
 	this->tessellationSlope = tessellationSlope;
@@ -27,19 +29,11 @@ TerrainSettings::TerrainSettings(const string& terrainName, Shader* terrainShade
 	this->normalTextureLocation = normalTextureLocation;
 
 
-	for (int i = 0; i < 8; i++) { // Setting morphing area
-		if (this->lodRange[i] == 0)
-		{
-			this->lodMorphingArea[i] = 0;
-		}
-		else
-		{
-			this->lodMorphingArea[i] = this->lodRange[i] - ((int)(scaleXZ / 8.0f / glm::pow(2, i + 1)));
-		}
-	}
+	CalculateLodMorphingArea();
 
 	heightmap = new Texture(this->heightmapLocation, TexType::Heightmap);
 	heightmap->LoadTexture();
+	LoadHeightGrid();
 
 	normalTexture = new Texture(this->normalTextureLocation, TexType::Normal);
 	normalTexture->LoadTexture();
@@ -68,6 +62,113 @@ TerrainSettings::TerrainSettings(const string& terrainName, Shader* terrainShade
 }
 
 
+void TerrainSettings::SetDetailScale(GLfloat value)
+{
+	if (value == detailScale)
+	{
+		return;
+	}
+	detailScale = value;
+
+	for (int i = 0; i < 8; i++)
+	{
+		if (configuredLodRange[i] == 0) //Unused lod stays unused
+		{
+			lodRange[i] = 0;
+		}
+		else
+		{
+			lodRange[i] = glm::max((GLuint)(configuredLodRange[i] * detailScale + 0.5f), 1u);
+		}
+	}
+	CalculateLodMorphingArea(); //Morphing area is relative to lod range
+}
+
+void TerrainSettings::CalculateLodMorphingArea()
+{
+	for (int i = 0; i < 8; i++) { // Setting morphing area
+		if (this->lodRange[i] == 0)
+		{
+			this->lodMorphingArea[i] = 0;
+		}
+		else
+		{
+			this->lodMorphingArea[i] = this->lodRange[i] - ((int)(scaleXZ / 8.0f / glm::pow(2, i + 1)));
+		}
+	}
+}
+
+void TerrainSettings::LoadHeightGrid()
+{
+	minHeightGrid.clear();
+	maxHeightGrid.clear();
+
+	int width, height, channels;
+	unsigned char *heightData = stbi_load(heightmapLocation, &width, &height, &channels, 0); //Same data as heightmap texture, shaders read red channel
+	if (!heightData)
+	{
+		printf("ERROR: Failed to load heightmap %s for terrain height grid\n", heightmapLocation);
+		return;
+	}
+
+	minHeightGrid.resize(TERRAIN_HEIGHT_GRID * TERRAIN_HEIGHT_GRID);
+	maxHeightGrid.resize(TERRAIN_HEIGHT_GRID * TERRAIN_HEIGHT_GRID);
+	for (int cellY = 0; cellY < TERRAIN_HEIGHT_GRID; cellY++)
+	{
+		for (int cellX = 0; cellX < TERRAIN_HEIGHT_GRID; cellX++)
+		{
+			//One texel of margin for bilinear filtering, wrapped around edges (covers both repeat and clamp to edge)
+			int firstX = cellX * width / TERRAIN_HEIGHT_GRID - 1;
+			int lastX = (cellX + 1) * width / TERRAIN_HEIGHT_GRID;
+			int firstY = cellY * height / TERRAIN_HEIGHT_GRID - 1;
+			int lastY = (cellY + 1) * height / TERRAIN_HEIGHT_GRID;
+
+			unsigned char lowest = 255, highest = 0;
+			for (int y = firstY; y <= lastY; y++)
+			{
+				for (int x = firstX; x <= lastX; x++)
+				{
+					unsigned char value = heightData[(((y + height) % height) * width + (x + width) % width) * channels]; //Row 0 is map coordinate 0 (texture is not flipped)
+					lowest = glm::min(lowest, value);
+					highest = glm::max(highest, value);
+				}
+			}
+			minHeightGrid[cellX + cellY * TERRAIN_HEIGHT_GRID] = lowest / 255.0f;
+			maxHeightGrid[cellX + cellY * TERRAIN_HEIGHT_GRID] = highest / 255.0f;
+		}
+	}
+
+	stbi_image_free(heightData);
+}
+
+GLfloat TerrainSettings::GetMinHeight(glm::vec2 mapMin, glm::vec2 mapMax)
+{
+	if (minHeightGrid.empty()) { return 0.0f; }
+
+	glm::ivec2 first = glm::clamp(glm::ivec2(glm::floor(mapMin * (GLfloat)TERRAIN_HEIGHT_GRID)), 0, TERRAIN_HEIGHT_GRID - 1);
+	glm::ivec2 last = glm::clamp(glm::ivec2(glm::ceil(mapMax * (GLfloat)TERRAIN_HEIGHT_GRID)) - 1, first, glm::ivec2(TERRAIN_HEIGHT_GRID - 1));
+	GLfloat lowest = 1.0f;
+	for (int y = first.y; y <= last.y; y++)
+	{
+		for (int x = first.x; x <= last.x; x++) { lowest = glm::min(lowest, minHeightGrid[x + y * TERRAIN_HEIGHT_GRID]); }
+	}
+	return lowest;
+}
+
+GLfloat TerrainSettings::GetMaxHeight(glm::vec2 mapMin, glm::vec2 mapMax)
+{
+	if (maxHeightGrid.empty()) { return 1.0f; }
+
+	glm::ivec2 first = glm::clamp(glm::ivec2(glm::floor(mapMin * (GLfloat)TERRAIN_HEIGHT_GRID)), 0, TERRAIN_HEIGHT_GRID - 1);
+	glm::ivec2 last = glm::clamp(glm::ivec2(glm::ceil(mapMax * (GLfloat)TERRAIN_HEIGHT_GRID)) - 1, first, glm::ivec2(TERRAIN_HEIGHT_GRID - 1));
+	GLfloat highest = 0.0f;
+	for (int y = first.y; y <= last.y; y++)
+	{
+		for (int x = first.x; x <= last.x; x++) { highest = glm::max(highest, maxHeightGrid[x + y * TERRAIN_HEIGHT_GRID]); }
+	}
+	return highest;
+}
+
 TerrainSettings::~TerrainSettings()
 {
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include <glm\glm.hpp>
 #include "..\Shader.h"
 #include "..\Camera.h"
@@ -19,9 +21,13 @@ public:
 	GLfloat GetScaleY() { return scaleY; }
 	void SetScaleY(GLfloat value) { scaleY = value; }
 
-	GLuint *GetLodRange() { return lodRange; }
+	GLuint *GetLodRange() { return lodRange; } //Scaled by detail scale
 	GLuint *GetLodMorphingArea() { return lodMorphingArea; }
 
+	GLfloat GetDetailScale() { return detailScale; }
+	void SetDetailScale(GLfloat value); //Scales lod ranges and tessellation factor (quality governor), configured values are kept
+	GLuint GetDetailTessellationFactor() { return (GLuint)(tessellationFactor * detailScale + 0.5f); } //Tessellation factor used for rendering
+
 	GLuint GetTessellationFactor() { return tessellationFactor; };
 	void SetTessellationFactor(GLuint value) { tessellationFactor = value; }
 	GLfloat GetTessellationSlope() { return tessellationSlope; };
@@ -55,6 +61,9 @@ public:
 	GLuint GetTerrainUniform_textureNormal() { return terrainUniform_textureNormal; }
 
 	Texture *GetHeightmap() { return heightmap; }
+	//Lowest and highest heightmap value (0 - 1, not scaled) that rendered terrain can have inside of map space rectangle, from CPU height grid
+	GLfloat GetMinHeight(glm::vec2 mapMin, glm::vec2 mapMax);
+	GLfloat GetMaxHeight(glm::vec2 mapMin, glm::vec2 mapMax);
 	Texture *GetNormalTexture() { return normalTexture; }
 
 	~TerrainSettings();
@@ -70,8 +79,10 @@ private:
 	int rootNodeCount;
 	GLfloat scaleXZ;
 	GLfloat scaleY;
+	GLuint configuredLodRange[8];
 	GLuint lodRange[8];
 	GLuint lodMorphingArea[8];
+	GLfloat detailScale;
 	GLuint tessellationFactor;
 	GLfloat tessellationSlope;
 	GLfloat tessellationShift;
@@ -85,5 +96,11 @@ private:
 	GLuint terrainUniform_viewProjection;
 	GLuint terrainUniform_tessellationFactor, terrainUniform_tessellationSlope, terrainUniform_tessellationShift;
 	GLuint terrainUniform_textureNormal;
+
+	//TERRAIN_HEIGHT_GRID * TERRAIN_HEIGHT_GRID cells of the heightmap, each with range of texels that bilinear filtering can blend inside of the cell
+	std::vector<GLfloat> minHeightGrid, maxHeightGrid;
+
+	void CalculateLodMorphingArea();
+	void LoadHeightGrid();
 };
 
@@ -1,5 +1,8 @@
 #include "Texture.h"
 
+#include "RenderStats.h"
+#include "GLState.h"
+
 
 Texture::Texture()
 {
@@ -31,7 +34,7 @@ bool Texture::LoadTexture()
 	}
 
 	glGenTextures(1, &textureID); //Generate texture and apply ID to it
-	glBindTexture(GL_TEXTURE_2D, textureID);
+	GLState::BindTexture(GL_TEXTURE_2D, textureID);
 
 	//Setting parameters of texture
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT); //Wrapping x-axis
@@ -53,9 +56,10 @@ bool Texture::LoadTexture()
 	}
 
 	
+	RenderStats::Add(RENDER_STAT_TEXTURE_UPLOAD_BYTES, (unsigned long long)width * height * (bitDepth == 3 ? 3 : 4));
 	glGenerateMipmap(GL_TEXTURE_2D);
 
-	glBindTexture(GL_TEXTURE_2D, 0); //Unbind texture
+	GLState::BindTexture(GL_TEXTURE_2D, 0); //Unbind texture
 
 	stbi_image_free(texData); //Clear data because it was loaded to the texture and we dont need it anymore
 
@@ -64,29 +68,30 @@ bool Texture::LoadTexture()
 
 void Texture::UseTexture()
 {
-	if (texType == TexType::None) //Setting in texture Unit. (min texture units 16 on modern GPU)
+	int unit = GetTextureUnit();
+	if (unit < 0) //Setting in texture Unit. (min texture units 16 on modern GPU)
 	{
 		printf("Error while assigning texture to texture unit! None texture type\n");
+		return;
 	}
-	else if (texType == TexType::Diffuse)
-	{
-		glActiveTexture(GL_TEXTURE0 + DIFFUSE_TEXUNIT);
-	}
-	else if (texType == TexType::Normal)
-	{
-		glActiveTexture(GL_TEXTURE0 + NORMAL_TEXUNIT);
-	}
-	else if (texType == TexType::Heightmap)
+	GLState::BindTexture(unit, GL_TEXTURE_2D, textureID); //Texture unit is switched only when the texture bound to it changes
+}
+
+int Texture::GetTextureUnit()
+{
+	switch (texType)
 	{
-		glActiveTexture(GL_TEXTURE0 + HEIGHTMAP_TEXUNIT);
+	case TexType::Diffuse: return DIFFUSE_TEXUNIT;
+	case TexType::Normal: return NORMAL_TEXUNIT;
+	case TexType::Heightmap: return HEIGHTMAP_TEXUNIT;
+	default: return -1;
 	}
-
-	glBindTexture(GL_TEXTURE_2D, textureID); //Binding texture with given ID to Texture Unit in line above
 }
 
 void Texture::ClearTexture()
 {
 	glDeleteTextures(1, &textureID);
+	GLState::ForgetTexture(textureID);
 	textureID = 0;
 	width = 0;
 	height = 0;
@@ -14,6 +14,7 @@ public:
 
 	bool LoadTexture(); //Load texture without alpha channel
 	void UseTexture();
+	int GetTextureUnit(); //Unit the texture is bound to by its type, -1 for None
 	void ClearTexture();
 	GLuint GetTextureID() { return textureID; }
 	int GetWidth() { return width; }